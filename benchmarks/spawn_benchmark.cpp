@@ -0,0 +1,128 @@
+/** Spawn throughput benchmark: one entity at a time (CreateEntity + AddComponent) versus
+ * ComponentManager::CreateEntities and ComponentManager::InstantiatePrefab (copies of a 20-entity
+ * hierarchy), in both component storage modes.
+ *
+ * Usage: vee_spawn_benchmark [entity count]
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+#include "../src/engine/entities/components_system/component_manager.h"
+#include "../src/engine/entities/components_system/components/local_to_world_component.h"
+#include "../src/engine/entities/components_system/components/local_transform_component.h"
+#include "../src/engine/entities/components_system/components/parent_component.h"
+#include "../src/engine/entities/components_system/components/velocity_component.h"
+
+namespace {
+    /** System doing nothing, only there to receive membership updates.
+     */
+    template<int N>
+    class IdleSystem final : public SystemBase {
+    public:
+        using SystemBase::SystemBase;
+
+        void Update(float dt) override {
+        }
+    };
+
+    struct World {
+        std::shared_ptr<EntityManager> entityManager = std::make_shared<EntityManager>();
+        std::shared_ptr<SystemManager> systemManager = std::make_shared<SystemManager>();
+        std::shared_ptr<ComponentManager> componentManager;
+
+        explicit World(const ComponentStorageMode mode) {
+            componentManager = std::make_shared<ComponentManager>(systemManager, entityManager, mode);
+            componentManager->RegisterComponent<LocalTransformComponent>(VEE_LOCAL_TRANSFORM_COMPONENT_NAME);
+            componentManager->RegisterComponent<LocalToWorldComponent>(VEE_LOCAL_TO_WORLD_COMPONENT_NAME);
+            componentManager->RegisterComponent<VelocityComponent>(VEE_VELOCITY_COMPONENT_NAME);
+            componentManager->RegisterComponent<ParentComponent>(VEE_PARENT_COMPONENT_NAME);
+
+            Signature transform;
+            transform.set(ComponentTypeHelper<LocalTransformComponent>::ID);
+            Signature world = transform;
+            world.set(ComponentTypeHelper<LocalToWorldComponent>::ID);
+            Signature moving = transform;
+            moving.set(ComponentTypeHelper<VelocityComponent>::ID);
+
+            RegisterSystems(std::make_index_sequence<8>{}, transform, world, moving);
+        }
+
+        template<size_t... Is>
+        void RegisterSystems(std::index_sequence<Is...>, const Signature &a, const Signature &b, const Signature &c) {
+            const Signature signatures[] = {a, b, c};
+            ((systemManager->RegisterSystem<IdleSystem<Is> >(std::make_shared<IdleSystem<Is> >(componentManager)),
+              systemManager->SetSignature<IdleSystem<Is> >(signatures[Is % 3])), ...);
+        }
+    };
+
+    constexpr uint32_t PREFAB_SIZE = 20;
+
+    /** Root with a binary tree of transformed children.
+     */
+    Prefab MakePrefab() {
+        Prefab prefab;
+        for (uint32_t i = 0; i < PREFAB_SIZE; ++i) {
+            const auto index = prefab.AddEntity("Part", i == 0 ? Prefab::NO_PARENT : (i - 1) / 2);
+            prefab.AddComponent(index, LocalTransformComponent{
+                .position = glm::vec3(static_cast<float>(i), 0.0f, 0.0f)
+            });
+            prefab.AddComponent(index, LocalToWorldComponent{});
+        }
+        return prefab;
+    }
+
+    template<typename Func>
+    double Measure(const Func &func) {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void Report(const char *label, const size_t count, const double seconds) {
+        std::printf("  %-28s %8.2f ms  %10.2f M entities/s\n", label, seconds * 1000.0, count / seconds / 1e6);
+    }
+
+    void Run(const char *modeName, const ComponentStorageMode mode, const size_t count) {
+        std::printf("%s storage, %zu entities:\n", modeName, count);
+
+        World oneByOne(mode);
+        Report("CreateEntity + AddComponent", count, Measure([&] {
+            for (size_t i = 0; i < count; ++i) {
+                const auto entity = oneByOne.entityManager->CreateEntity("Crowd");
+                oneByOne.componentManager->AddComponent(entity, LocalTransformComponent{
+                    .position = glm::vec3(static_cast<float>(i), 0.0f, 0.0f)
+                });
+                oneByOne.componentManager->AddComponent(entity, LocalToWorldComponent{});
+                oneByOne.componentManager->AddComponent(entity, VelocityComponent{});
+            }
+        }));
+
+        World bulk(mode);
+        Report("CreateEntities", count, Measure([&] {
+            bulk.componentManager->CreateEntities<LocalTransformComponent, LocalToWorldComponent, VelocityComponent>(
+                count, "Crowd",
+                [](const size_t i, EntityID, LocalTransformComponent &transform, LocalToWorldComponent &,
+                   VelocityComponent &) {
+                    transform.position = glm::vec3(static_cast<float>(i), 0.0f, 0.0f);
+                }
+            );
+        }));
+
+        World prefabWorld(mode);
+        const Prefab prefab = MakePrefab();
+        const size_t instances = count / PREFAB_SIZE;
+        Report("InstantiatePrefab", instances * PREFAB_SIZE, Measure([&] {
+            prefabWorld.componentManager->InstantiatePrefab(prefab, instances);
+        }));
+    }
+}
+
+int main(const int argc, char **argv) {
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000;
+
+    Run("PerType", ComponentStorageMode::PerType, count);
+    Run("Archetype", ComponentStorageMode::Archetype, count);
+    return 0;
+}
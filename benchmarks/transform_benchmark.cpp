@@ -0,0 +1,149 @@
+/** Transform propagation benchmark: TransformSystem in serial and parallel mode, on a wide hierarchy (roots
+ * with many direct children) and a deep one (long parent chains), in both component storage modes.
+ *
+ * Each scene is measured on a full recompute (first update after spawning) and on a frame where every local
+ * transform was written (every subtree is dirty).
+ *
+ * Usage: vee_transform_benchmark [entity count] [frames]
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+#include "../src/engine/entities/components_system/component_manager.h"
+#include "../src/engine/entities/components_system/components/local_to_world_component.h"
+#include "../src/engine/entities/components_system/components/local_transform_component.h"
+#include "../src/engine/entities/components_system/components/parent_component.h"
+#include "../src/engine/entities/system/transform_system.h"
+#include "../src/engine/utils/entities/iteration.h"
+#include "../src/engine/utils/threading/thread_pool.h"
+
+namespace {
+    struct World {
+        std::shared_ptr<EntityManager> entityManager = std::make_shared<EntityManager>();
+        std::shared_ptr<SystemManager> systemManager = std::make_shared<SystemManager>();
+        std::shared_ptr<ComponentManager> componentManager;
+        std::shared_ptr<TransformSystem> transformSystem;
+
+        World(const ComponentStorageMode mode, const TransformPropagationMode propagationMode) {
+            componentManager = std::make_shared<ComponentManager>(systemManager, entityManager, mode);
+            componentManager->RegisterComponent<LocalTransformComponent>(VEE_LOCAL_TRANSFORM_COMPONENT_NAME);
+            componentManager->RegisterComponent<LocalToWorldComponent>(VEE_LOCAL_TO_WORLD_COMPONENT_NAME);
+            componentManager->RegisterComponent<ParentComponent>(VEE_PARENT_COMPONENT_NAME);
+
+            Signature signature;
+            signature.set(ComponentTypeHelper<LocalTransformComponent>::ID);
+            signature.set(ComponentTypeHelper<LocalToWorldComponent>::ID);
+            transformSystem = systemManager->RegisterSystem<TransformSystem>(
+                std::make_shared<TransformSystem>(componentManager)
+            );
+            systemManager->SetSignature<TransformSystem>(signature);
+            transformSystem->SetMode(propagationMode);
+        }
+
+        void Update(Utils::Threading::ThreadPool &threadPool) const {
+            systemManager->UpdateSystems(0.0f, componentManager->AdvanceChangeVersion(), &threadPool);
+        }
+    };
+
+    /** Adds a transformed entity to the prefab, slightly offset and rotated from its parent.
+     */
+    uint32_t AddPart(Prefab &prefab, const uint32_t parent) {
+        const auto index = prefab.AddEntity("Part", parent);
+        prefab.AddComponent(index, LocalTransformComponent{
+            .position = glm::vec3(1.0f, 0.0f, 0.0f),
+            .rotation = glm::angleAxis(0.1f, glm::vec3(0.0f, 1.0f, 0.0f)),
+            .scale = glm::vec3(1.0f)
+        });
+        prefab.AddComponent(index, LocalToWorldComponent{});
+        return index;
+    }
+
+    /** One root with `size - 1` direct children.
+     */
+    Prefab MakeWidePrefab(const uint32_t size) {
+        Prefab prefab;
+        const auto root = AddPart(prefab, Prefab::NO_PARENT);
+        for (uint32_t i = 1; i < size; ++i) {
+            AddPart(prefab, root);
+        }
+        return prefab;
+    }
+
+    /** A chain of `size` entities, each one the parent of the next.
+     */
+    Prefab MakeDeepPrefab(const uint32_t size) {
+        Prefab prefab;
+        uint32_t parent = Prefab::NO_PARENT;
+        for (uint32_t i = 0; i < size; ++i) {
+            parent = AddPart(prefab, parent);
+        }
+        return prefab;
+    }
+
+    template<typename Func>
+    double Measure(const Func &func) {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void Report(const char *label, const size_t count, const double seconds) {
+        std::printf("    %-20s %8.2f ms  %10.2f M transforms/s\n", label, seconds * 1000.0, count / seconds / 1e6);
+    }
+
+    void RunScene(
+        const char *sceneName,
+        const Prefab &prefab,
+        const size_t instances,
+        const ComponentStorageMode mode,
+        const size_t frames,
+        Utils::Threading::ThreadPool &threadPool
+    ) {
+        const size_t count = instances * prefab.Size();
+        std::printf("  %s scene, %zu transforms:\n", sceneName, count);
+
+        for (const auto propagationMode: {TransformPropagationMode::Serial, TransformPropagationMode::Parallel}) {
+            const bool parallel = propagationMode == TransformPropagationMode::Parallel;
+            World world(mode, propagationMode);
+            world.componentManager->InstantiatePrefab(prefab, instances);
+
+            Report(parallel ? "parallel, full" : "serial, full", count, Measure([&] {
+                world.Update(threadPool);
+            }));
+
+            double seconds = 0.0;
+            for (size_t frame = 0; frame < frames; ++frame) {
+                Utils::Entities::Iteration::View<LocalTransformComponent>(*world.componentManager)
+                        .Each([](LocalTransformComponent &transform) {
+                            transform.position.y += 0.01f;
+                        });
+                seconds += Measure([&] {
+                    world.Update(threadPool);
+                });
+            }
+            Report(parallel ? "parallel, all dirty" : "serial, all dirty", count, seconds / frames);
+        }
+    }
+
+    void Run(const char *modeName, const ComponentStorageMode mode, const size_t count, const size_t frames,
+             Utils::Threading::ThreadPool &threadPool) {
+        constexpr uint32_t WIDTH = 1000;
+        constexpr uint32_t DEPTH = 500;
+
+        std::printf("%s storage, %zu workers:\n", modeName, threadPool.GetWorkerCount());
+        RunScene("Wide", MakeWidePrefab(WIDTH), std::max<size_t>(1, count / WIDTH), mode, frames, threadPool);
+        RunScene("Deep", MakeDeepPrefab(DEPTH), std::max<size_t>(1, count / DEPTH), mode, frames, threadPool);
+    }
+}
+
+int main(const int argc, char **argv) {
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500000;
+    const size_t frames = argc > 2 ? std::max<size_t>(1, std::strtoul(argv[2], nullptr, 10)) : 10;
+
+    Utils::Threading::ThreadPool threadPool;
+    Run("PerType", ComponentStorageMode::PerType, count, frames, threadPool);
+    Run("Archetype", ComponentStorageMode::Archetype, count, frames, threadPool);
+    return 0;
+}
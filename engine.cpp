@@ -14,6 +14,7 @@
 #include <iostream>
 #include <stdexcept>
 #include <cstdlib>
+#include <string_view>
 
 #include "src/engine/engine.h"
 
@@ -34,7 +35,7 @@
 constexpr uint32_t WIDTH = 1200;
 constexpr uint32_t HEIGHT = 600;
 
-int main() {
+int main(const int argc, char **argv) {
     const auto g_Window = std::make_shared<Window>(WIDTH, HEIGHT, "Engine Window");
 
     const auto g_Renderer = std::make_shared<Vulkan::Renderer>(g_Window);
@@ -58,6 +59,14 @@ int main() {
             systemManager->template SetSignature<CameraSystem>(activeCameraSignature);
         });
 
+        for (int i = 1; i < argc; ++i) {
+            if (std::string_view(argv[i]) == "--gpu-transforms") {
+                g_Engine->SetTransformPropagationMode(TransformPropagationMode::Gpu);
+            } else if (std::string_view(argv[i]) == "--render-thread") {
+                g_Engine->SetRenderThreadEnabled(true);
+            }
+        }
+
         g_Engine->LoadScene("../.editor_data/scenes/scene1.scene");
 
         g_Engine->Initialize("Engine", VK_MAKE_VERSION(1, 0, 0));
@@ -82,9 +91,9 @@ int main() {
             startTime = std::chrono::high_resolution_clock::now();
 
             glfwPollEvents();
-            g_Engine->UpdateSystems(deltaTime);
+            g_Engine->Update(deltaTime);
             g_Engine->PrepareForRendering();
-            g_Engine->GetRenderer()->Draw();
+            g_Engine->Render();
             InputSystem::UpdateEndOfFrame();
         }
     } catch (const std::exception &e) {
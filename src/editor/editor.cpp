@@ -4,7 +4,6 @@
 #include "imgui_internal.h"
 #include "../engine/entities/components_system/components/renderable_component.h"
 #include "../engine/entities/components_system/components/camera_component.h"
-#include "../engine/entities/components_system/components/children_component.h"
 #include "../engine/entities/components_system/components/local_transform_component.h"
 #include "../engine/entities/components_system/tags/editor_camera_tag_component.h"
 #include "../engine/entities/components_system/tags/internal_tag_component.h"
@@ -98,7 +97,7 @@ void VeeEditor::Run() {
         const float deltaTime = std::chrono::duration<float>(currentTime - lastTime).count();
         lastTime = currentTime;
 
-        m_Engine->UpdateSystems(deltaTime);
+        m_Engine->Update(deltaTime);
 
         m_Engine->PrepareForRendering();
 
@@ -108,7 +107,7 @@ void VeeEditor::Run() {
 
         ImGui::Render();
 
-        m_Engine->GetRenderer()->Draw();
+        m_Engine->Render();
 
         InputSystem::UpdateEndOfFrame();
     }
@@ -136,11 +136,14 @@ void Vulkan::RendererWithUi::ExecutePickingPass(const VkCommandBuffer &cmd) cons
         &dynamicOffset
     );
 
-    for (const auto &drawCall: m_DrawQueue) {
+    BindTransformDescriptorSet(cmd);
+
+    for (const auto &drawCall: GetPublishedRenderSnapshot().drawPackets) {
         PushData pushData = {
             drawCall.worldMatrix,
             drawCall.textureId,
-            drawCall.entityId
+            drawCall.entityId,
+            drawCall.transformIndex
         };
         vkCmdPushConstants(
             cmd,
@@ -207,6 +210,8 @@ void Vulkan::RendererWithUi::UpdatePickingResult() {
 void Vulkan::RendererWithUi::BuildRenderGraph() {
     UpdatePickingResult();
 
+    AddTransformPass();
+
     if (m_PickingRequest.isPending) {
         m_RenderGraph->AddPass({
             .name = "Picking",
@@ -412,6 +417,7 @@ void Vulkan::RendererWithUi::CleanupPickingResources() {
 }
 
 void Vulkan::RendererWithUi::PrepareForRendering() {
+    Renderer::PrepareForRendering();
     ImGui_ImplVulkan_NewFrame();
     ImGui_ImplGlfw_NewFrame();
 }
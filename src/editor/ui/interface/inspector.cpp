@@ -1,7 +1,6 @@
 #include "inspector.h"
 
 #include "../../../engine/entities/components_system/components/camera_component.h"
-#include "../../../engine/entities/components_system/components/children_component.h"
 #include "../../../engine/entities/components_system/components/local_to_world_component.h"
 #include "../../../engine/entities/components_system/components/local_transform_component.h"
 #include "../../../engine/entities/components_system/components/parent_component.h"
@@ -30,6 +29,61 @@ void Editor::UI::Inspector::DrawSceneInspector(const VeeEditor *editor, const st
     ImGui::Text("DEBUG: Current camera entityID : %d", editor->GetEngine()->GetActiveCameraEntityId());
 }
 
+void Editor::UI::Inspector::DrawChildren(const std::shared_ptr<Scene> &scene, const EntityID entity) {
+    const auto componentManager = scene->GetComponentManager();
+    const auto entityManager = scene->GetEntityManager();
+    const auto &hierarchy = componentManager->GetHierarchy();
+
+    if (!ImGui::CollapsingHeader("Hierarchy Children", ImGuiTreeNodeFlags_DefaultOpen)) {
+        return;
+    }
+
+    ImGui::Text("Children Count: %u", hierarchy.GetChildCount(entity));
+    ImGui::Separator();
+
+    // Detached after the walk: the hierarchy must not change while its children are listed.
+    EntityID detachedChild = NULL_ENTITY;
+    int childIndex = 0;
+    hierarchy.ForEachChild(entity, [&](const EntityID childId) {
+        ImGui::Text("%d: %s", childIndex++, entityManager->GetEntityName(childId).data());
+        ImGui::SameLine();
+
+        ImGui::PushID(static_cast<int>(childId));
+        if (ImGui::SmallButton("Detach")) {
+            detachedChild = childId;
+        }
+        ImGui::PopID();
+    });
+    if (detachedChild != NULL_ENTITY) {
+        Utils::Entities::Hierarchy::SetParent(detachedChild, NULL_ENTITY, componentManager);
+    }
+    ImGui::Separator();
+
+    const std::string add_child_preview = "Add Existing Entity as Child";
+
+    if (ImGui::BeginCombo("##AddChildCombo", add_child_preview.c_str())) {
+        for (const EntityID entityId: entityManager->GetActiveEntities()) {
+            if (
+                entityId == entity
+                || entityId == NULL_ENTITY
+                || hierarchy.GetParent(entityId) == entity
+                || hierarchy.IsDescendantOf(entity, entityId)
+            ) {
+                continue;
+            }
+
+            if (ImGui::Selectable(entityManager->GetEntityName(entityId).data())) {
+                Utils::Entities::Hierarchy::AddChild(
+                    entity,
+                    entityId,
+                    componentManager
+                );
+            }
+        }
+        ImGui::EndCombo();
+    }
+}
+
 void Editor::UI::Inspector::DrawEntityInspector(
     VeeEditor *editor,
     const std::shared_ptr<Scene> &scene,
@@ -40,15 +94,15 @@ void Editor::UI::Inspector::DrawEntityInspector(
     const auto entityComponents = componentManager->GetEntityComponents(entity);
     const auto isInternal = componentManager->HasComponent<InternalTagComponent>(entity);
 
-    const std::string entityNameString = entityManager->GetEntityName(entity);
+    const std::string_view entityNameString = entityManager->GetEntityName(entity);
     char entityName[256];
-    std::strncpy(entityName, entityNameString.c_str(), sizeof(entityName));
+    std::strncpy(entityName, entityNameString.data(), sizeof(entityName));
     ImGui::InputText(
         "Name",
         entityName,
         IM_ARRAYSIZE(entityName)
     );
-    if (const auto newName = std::string(entityName); newName != entityNameString) {
+    if (const auto newName = std::string_view(entityName); newName != entityNameString) {
         entityManager->RenameEntity(
             entity,
             newName
@@ -64,53 +118,66 @@ void Editor::UI::Inspector::DrawEntityInspector(
 
         if (componentTypeID == ComponentTypeHelper<LocalTransformComponent>::ID) {
             if (ImGui::CollapsingHeader("Transform", flags)) {
-                auto &transform = componentManager->GetComponent<LocalTransformComponent>(entity);
+                // Edited on a copy, and only written back (marked as changed) when a field was edited, so the
+                // TransformSystem does not recompute the selected subtree every frame.
+                auto transform = componentManager->GetComponentReadOnly<LocalTransformComponent>(entity);
 
-                ImGui::DragFloat3(
+                bool edited = ImGui::DragFloat3(
                     "Position",
                     &transform.position.x,
                     0.1f
                 );
 
                 auto rotation = glm::eulerAngles(transform.rotation) * 180.0f / glm::pi<float>();
-                ImGui::DragFloat3(
+                if (ImGui::DragFloat3(
                     "Rotation",
                     &rotation.x,
                     1.0f,
                     -360.0f,
                     360.0f
-                );
-
-                transform.rotation = glm::quat(rotation * glm::pi<float>() / 180.0f);
+                )) {
+                    transform.rotation = glm::quat(rotation * glm::pi<float>() / 180.0f);
+                    edited = true;
+                }
 
-                ImGui::DragFloat3(
+                edited |= ImGui::DragFloat3(
                     "Scale",
                     &transform.scale.x,
                     0.1f,
                     0.01f,
                     100.0f
                 );
+
+                if (edited) {
+                    componentManager->GetComponent<LocalTransformComponent>(entity) = transform;
+                }
             }
         } else if (componentTypeID == ComponentTypeHelper<CameraComponent>::ID) {
             if (ImGui::CollapsingHeader("Camera", flags)) {
-                auto &camera = componentManager->GetComponent<CameraComponent>(entity);
+                auto camera = componentManager->GetComponentReadOnly<CameraComponent>(entity);
 
+                bool edited = false;
                 const char *projectionTypes[] = {"Perspective", "Orthographic"};
                 int currentType = camera.projection;
                 if (ImGui::Combo("Projection", &currentType, projectionTypes, IM_ARRAYSIZE(projectionTypes))) {
                     camera.projection = static_cast<ProjectionType>(currentType);
+                    edited = true;
                 }
 
-                ImGui::DragFloat("Field of View", &camera.fieldOfView, 0.1f, 1.0f, 179.0f);
+                edited |= ImGui::DragFloat("Field of View", &camera.fieldOfView, 0.1f, 1.0f, 179.0f);
 
-                ImGui::DragFloat("Near Plane", &camera.nearPlane, 0.01f, 0.01f, camera.farPlane - 0.1f);
+                edited |= ImGui::DragFloat("Near Plane", &camera.nearPlane, 0.01f, 0.01f, camera.farPlane - 0.1f);
 
-                ImGui::DragFloat("Far Plane", &camera.farPlane, 0.1f, camera.nearPlane + 0.1f, 10000.0f);
+                edited |= ImGui::DragFloat("Far Plane", &camera.farPlane, 0.1f, camera.nearPlane + 0.1f, 10000.0f);
 
-                ImGui::DragFloat("Aspect Ratio", &camera.aspectRatio, 0.01f, 0.0f, 2.0f);
+                edited |= ImGui::DragFloat("Aspect Ratio", &camera.aspectRatio, 0.01f, 0.0f, 2.0f);
 
                 if (camera.projection == ORTHOGRAPHIC) {
-                    ImGui::DragFloat("Ortho Scale", &camera.orthoScale, 0.1f, 0.1f, 1000.0f);
+                    edited |= ImGui::DragFloat("Ortho Scale", &camera.orthoScale, 0.1f, 0.1f, 1000.0f);
+                }
+
+                if (edited) {
+                    componentManager->GetComponent<CameraComponent>(entity) = camera;
                 }
 
                 auto isActive = componentManager->HasComponent<ActiveCameraTagComponent>(entity);
@@ -125,25 +192,29 @@ void Editor::UI::Inspector::DrawEntityInspector(
             }
         } else if (componentTypeID == ComponentTypeHelper<VelocityComponent>::ID) {
             if (ImGui::CollapsingHeader("Velocity", flags)) {
-                auto &velocity = componentManager->GetComponent<VelocityComponent>(entity);
+                auto velocity = componentManager->GetComponentReadOnly<VelocityComponent>(entity);
 
-                ImGui::DragFloat3(
+                bool edited = ImGui::DragFloat3(
                     "Linear",
                     &velocity.linearVelocity.x,
                     0.1f
                 );
 
-                ImGui::DragFloat3(
+                edited |= ImGui::DragFloat3(
                     "Angular",
                     &velocity.angularVelocity.x,
                     0.1f
                 );
+
+                if (edited) {
+                    componentManager->GetComponent<VelocityComponent>(entity) = velocity;
+                }
             }
         } else if (componentTypeID == ComponentTypeHelper<RenderableComponent>::ID) {
             if (ImGui::CollapsingHeader("Rendering", flags)) {
-                auto &renderable = componentManager->GetComponent<RenderableComponent>(entity);
+                auto renderable = componentManager->GetComponentReadOnly<RenderableComponent>(entity);
 
-                ImGui::InputScalar(
+                bool edited = ImGui::InputScalar(
                     "Mesh ID",
                     ImGuiDataType_U32,
                     &renderable.meshId,
@@ -152,7 +223,7 @@ void Editor::UI::Inspector::DrawEntityInspector(
                     "%u"
                 );
 
-                ImGui::InputScalar(
+                edited |= ImGui::InputScalar(
                     "Texture ID",
                     ImGuiDataType_U32,
                     &renderable.textureId,
@@ -160,11 +231,15 @@ void Editor::UI::Inspector::DrawEntityInspector(
                     nullptr,
                     "%u"
                 );
+
+                if (edited) {
+                    componentManager->GetComponent<RenderableComponent>(entity) = renderable;
+                }
             }
         } else if (componentTypeID == ComponentTypeHelper<LocalToWorldComponent>::ID) {
             if (showDebugInfo) {
                 if (ImGui::CollapsingHeader("World Matrix (Debug)", flags)) {
-                    auto &l2w = componentManager->GetComponent<LocalToWorldComponent>(entity);
+                    const auto &l2w = componentManager->GetComponentReadOnly<LocalToWorldComponent>(entity);
 
                     ImGui::Text("Matrix isDirty: %s", l2w.isDirty ? "True" : "False");
                     ImGui::Separator();
@@ -182,88 +257,38 @@ void Editor::UI::Inspector::DrawEntityInspector(
             }
         } else if (componentTypeID == ComponentTypeHelper<ParentComponent>::ID) {
             if (ImGui::CollapsingHeader("Hierarchy Parent", flags)) {
-                auto &parentComp = componentManager->GetComponent<ParentComponent>(entity);
-                EntityID currentParentId = parentComp.parent;
-                std::string currentParentName = (currentParentId == NULL_ENTITY)
-                                                    ? "None"
-                                                    : entityManager->GetEntityName(currentParentId);
+                const EntityID currentParentId = componentManager->GetComponentReadOnly<ParentComponent>(entity).parent;
+                const std::string_view currentParentName = (currentParentId == NULL_ENTITY)
+                                                               ? "None"
+                                                               : entityManager->GetEntityName(currentParentId);
 
-                if (ImGui::BeginCombo("Parent", currentParentName.c_str())) {
+                if (ImGui::BeginCombo("Parent", currentParentName.data())) {
                     bool is_none_selected = currentParentId == NULL_ENTITY;
                     if (ImGui::Selectable("None", &is_none_selected)) {
                         Utils::Entities::Hierarchy::SetParent(entity, NULL_ENTITY, componentManager);
                     }
 
-                    // Option 2: List all other entities
-                    // This is an expensive operation; a better solution is to cache entity lists.
-                    // TODO: implement parent/child entity list caching to optimize this.
-                    for (const auto &entityData: entityManager->GetAllEntities()) {
-                        EntityID entityId = entityData.id;
-
-                        if (entityId == entity || entityId == NULL_ENTITY) {
+                    // Option 2: List all other entities, except the descendants (which would create a cycle)
+                    const auto &hierarchy = componentManager->GetHierarchy();
+                    for (const EntityID entityId: entityManager->GetActiveEntities()) {
+                        if (entityId == entity || entityId == NULL_ENTITY || hierarchy.IsDescendantOf(entityId, entity)) {
                             continue;
                         }
 
                         bool is_selected = (entityId == currentParentId);
 
-                        if (ImGui::Selectable(entityData.name.c_str(), &is_selected)) {
+                        if (ImGui::Selectable(entityManager->GetEntityName(entityId).data(), &is_selected)) {
                             Utils::Entities::Hierarchy::SetParent(entity, entityId, componentManager);
                         }
                     }
                     ImGui::EndCombo();
                 }
             }
-        } else if (componentTypeID == ComponentTypeHelper<ChildrenComponent>::ID) {
-            if (ImGui::CollapsingHeader("Hierarchy Children", flags)) {
-                auto &childrenComp = componentManager->GetComponent<ChildrenComponent>(entity);
-
-                ImGui::Text("Children Count: %zu", childrenComp.children.size());
-                ImGui::Separator();
-
-                int childIndex = 0;
-                for (EntityID childId: childrenComp.children) {
-                    std::string childName = entityManager->GetEntityName(childId);
-                    ImGui::Text("%d: %s", childIndex++, childName.c_str());
-                    ImGui::SameLine();
-
-                    ImGui::PushID(childId);
-                    if (ImGui::SmallButton("Detach")) {
-                        Utils::Entities::Hierarchy::SetParent(childId, NULL_ENTITY, componentManager);
-                    }
-                    ImGui::PopID();
-                }
-                ImGui::Separator();
-
-                const std::string add_child_preview = "Add Existing Entity as Child";
-
-                if (ImGui::BeginCombo("##AddChildCombo", add_child_preview.c_str())) {
-                    for (const auto &entityData: entityManager->GetAllEntities()) {
-                        EntityID entityId = entityData.id;
-
-                        if (
-                            entityId == entity
-                            || entityId == NULL_ENTITY
-                            || childrenComp.children.contains(entityId)
-                        ) {
-                            continue;
-                        }
-
-                        if (ImGui::Selectable(entityData.name.c_str())) {
-                            Utils::Entities::Hierarchy::AddChild(
-                                entity,
-                                entityId,
-                                componentManager
-                            );
-                        }
-                    }
-                    ImGui::EndCombo();
-                }
-            }
         } else if (componentTypeID == ComponentTypeHelper<PhysicsSettingsComponent>::ID) {
             if (ImGui::CollapsingHeader("Physics Settings", flags)) {
-                auto &physicsSettings = componentManager->GetComponent<PhysicsSettingsComponent>(entity);
+                auto physicsSettings = componentManager->GetComponentReadOnly<PhysicsSettingsComponent>(entity);
 
-                ImGui::DragFloat(
+                bool edited = ImGui::DragFloat(
                     "Gravity Acceleration",
                     &physicsSettings.gravityAcceleration,
                     0.1f,
@@ -283,20 +308,25 @@ void Editor::UI::Inspector::DrawEntityInspector(
 
                 if (ImGui::IsItemDeactivatedAfterEdit()) {
                     physicsSettings.gravityDirection = glm::normalize(tempGravityDir);
+                    edited = true;
                 }
 
-                ImGui::DragInt(
+                edited |= ImGui::DragInt(
                     "Solver Iterations",
                     &physicsSettings.solverIterations,
                     1,
                     1, 100
                 );
+
+                if (edited) {
+                    componentManager->GetComponent<PhysicsSettingsComponent>(entity) = physicsSettings;
+                }
             }
         } else if (componentTypeID == ComponentTypeHelper<PlayerControllerComponent>::ID) {
             if (ImGui::CollapsingHeader("Player Controller", flags)) {
-                auto &playerController = componentManager->GetComponent<PlayerControllerComponent>(entity);
+                auto playerController = componentManager->GetComponentReadOnly<PlayerControllerComponent>(entity);
 
-                ImGui::DragFloat(
+                bool edited = ImGui::DragFloat(
                     "Movement Speed",
                     &playerController.movementSpeed,
                     0.1f,
@@ -316,11 +346,18 @@ void Editor::UI::Inspector::DrawEntityInspector(
 
                 if (ImGui::IsItemDeactivatedAfterEdit()) {
                     playerController.forwardDirection = glm::normalize(tempForwardDirection);
+                    edited = true;
+                }
+
+                if (edited) {
+                    componentManager->GetComponent<PlayerControllerComponent>(entity) = playerController;
                 }
             }
         }
     }
 
+    DrawChildren(scene, entity);
+
     if (!isInternal) {
         ImGui::Separator();
 
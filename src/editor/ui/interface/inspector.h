@@ -19,6 +19,13 @@ namespace Editor::UI {
          */
         static void DrawEntityInspector(VeeEditor *editor, const std::shared_ptr<Scene> &scene, EntityID entity);
 
+        /** Draws the children of an entity, with controls to detach them or to adopt other entities.
+         *
+         * @param scene Shared pointer to the current scene.
+         * @param entity The ID of the inspected entity.
+         */
+        static void DrawChildren(const std::shared_ptr<Scene> &scene, EntityID entity);
+
     public:
         /** Draws the Inspector window.
          *
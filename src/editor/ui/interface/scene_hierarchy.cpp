@@ -1,50 +1,49 @@
 #include "scene_hierarchy.h"
 
-#include "../../../engine/entities/components_system/components/parent_component.h"
-#include "../../../engine/utils/strings.h"
-
 void Editor::UI::SceneHierarchy::DrawHierarchy(VeeEditor *editor, const std::shared_ptr<Scene> &scene) {
-    const auto entityManager = scene->GetEntityManager();
     const auto componentManager = scene->GetComponentManager();
 
-    // 1. Identify all root entities to begin the draw.
-    // We iterate over all entities and filter for those without a ParentComponent
-    // or whose ParentComponent points to NULL_ENTITY.
-    for (const auto &entityData: entityManager->GetAllEntities()) {
-        const EntityID entityID = entityData.id;
-
-        // Check for ParentComponent presence and value
-        bool isRoot = true;
-        if (componentManager->HasComponent<ParentComponent>(entityID)) {
-            const auto &parentComp = componentManager->GetComponent<ParentComponent>(entityID);
-            if (parentComp.parent != NULL_ENTITY) {
-                isRoot = false;
-            }
-        }
-
-        // Skip internal entities unless debug info is enabled
-        const bool isInternal = componentManager->HasComponent<InternalTagComponent>(entityID);
-        if (!editor->GetEditorSettings().displayDebugInfo && isInternal) {
-            continue;
+    // The hierarchy is flattened in depth-first order: a closed node skips its whole subtree at once,
+    // and the tree nodes of the open ones are popped when the walk leaves their subtree.
+    const auto &hierarchy = componentManager->GetHierarchy();
+    const auto &entities = hierarchy.GetEntities();
+    const auto &subtreeSizes = hierarchy.GetSubtreeSizes();
+    const bool displayInternal = editor->GetEditorSettings().displayDebugInfo;
+
+    std::vector<size_t> openSubtreeEnds;
+    size_t position = 0;
+    while (position < entities.size()) {
+        const EntityID entityID = entities[position];
+        const size_t subtreeEnd = position + subtreeSizes[position];
+
+        // Skip internal entities (and their children) unless debug info is enabled
+        if (!displayInternal && componentManager->HasComponent<InternalTagComponent>(entityID)) {
+            position = subtreeEnd;
+        } else if (DrawEntityNode(editor, scene, entityID, subtreeSizes[position] > 1)) {
+            openSubtreeEnds.push_back(subtreeEnd);
+            ++position;
+        } else {
+            position = subtreeEnd;
         }
 
-        if (isRoot) {
-            DrawEntityNode(editor, scene, entityID);
+        while (!openSubtreeEnds.empty() && openSubtreeEnds.back() == position) {
+            ImGui::TreePop();
+            openSubtreeEnds.pop_back();
         }
     }
 }
 
-void Editor::UI::SceneHierarchy::DrawEntityNode(
+bool Editor::UI::SceneHierarchy::DrawEntityNode(
     VeeEditor *editor,
     const std::shared_ptr<Scene> &scene,
-    const EntityID entityID
+    const EntityID entityID,
+    const bool hasChildren
 ) {
     const auto entityManager = scene->GetEntityManager();
     const auto componentManager = scene->GetComponentManager();
 
     ImGuiTreeNodeFlags nodeFlags = ImGuiTreeNodeFlags_OpenOnArrow;
 
-    const bool hasChildren = componentManager->HasComponent<ChildrenComponent>(entityID);
     if (!hasChildren) {
         nodeFlags |= ImGuiTreeNodeFlags_Leaf;
     }
@@ -54,30 +53,24 @@ void Editor::UI::SceneHierarchy::DrawEntityNode(
     }
 
     const bool isInternal = componentManager->HasComponent<InternalTagComponent>(entityID);
-    const std::string entityName = entityManager->GetEntityName(entityID);
+    const std::string_view entityName = entityManager->GetEntityName(entityID);
 
+    // Truncated through the format precision, the name is not copied
+    const bool isTruncated = entityName.size() > MAX_DISPLAYED_NAME_LENGTH;
     const bool nodeOpen = ImGui::TreeNodeEx(
         reinterpret_cast<void *>(static_cast<uintptr_t>(entityID)),
         nodeFlags,
-        isInternal ? "%s (Internal)" : "%s",
-        Utils::Strings::TruncateString(entityName, 20).c_str()
+        isInternal ? "%.*s%s (Internal)" : "%.*s%s",
+        static_cast<int>(isTruncated ? MAX_DISPLAYED_NAME_LENGTH : entityName.size()),
+        entityName.data(),
+        isTruncated ? "..." : ""
     );
 
     if (ImGui::IsItemClicked()) {
         editor->SelectEntity(entityID);
     }
 
-    if (nodeOpen) {
-        if (hasChildren) {
-            const auto &childrenComp = componentManager->GetComponent<ChildrenComponent>(entityID);
-
-            for (const EntityID childID: childrenComp.children) {
-                DrawEntityNode(editor, scene, childID);
-            }
-        }
-
-        ImGui::TreePop();
-    }
+    return nodeOpen;
 }
 
 void Editor::UI::SceneHierarchy::DrawScenePicker(VeeEditor *editor, const std::shared_ptr<Scene> &scene) {
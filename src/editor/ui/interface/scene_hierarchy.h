@@ -1,11 +1,14 @@
 #ifndef VEE_SCENE_HIERARCHY_H
 #define VEE_SCENE_HIERARCHY_H
 #include "../../editor.h"
-#include "../../../engine/entities/components_system/components/children_component.h"
 #include "../../../engine/scenes/scene.h"
 
 namespace Editor::UI {
     class SceneHierarchy {
+        /** Longer entity names are truncated in the hierarchy tree.
+         */
+        static constexpr size_t MAX_DISPLAYED_NAME_LENGTH = 20;
+
         /** Draws the scene hierarchy UI component.
          *
          * @param editor Pointer to the VeeEditor instance.
@@ -16,15 +19,20 @@ namespace Editor::UI {
             const std::shared_ptr<Scene> &scene
         );
 
-        /** Draws a single entity node in the scene hierarchy.
-         *
-         * Called recursively to draw child entities.
+        /** Draws a single entity node in the scene hierarchy, without its children.
          *
          * @param editor Pointer to the VeeEditor instance.
          * @param scene Shared pointer to the current scene.
          * @param entityID The ID of the entity to draw.
+         * @param hasChildren Whether the node can be expanded.
+         * @return Whether the node is open, in which case the caller must pop it once its children are drawn.
          */
-        static void DrawEntityNode(VeeEditor *editor, const std::shared_ptr<Scene> &scene, EntityID entityID);
+        static bool DrawEntityNode(
+            VeeEditor *editor,
+            const std::shared_ptr<Scene> &scene,
+            EntityID entityID,
+            bool hasChildren
+        );
 
         /** Draws the scene picker UI component.
          *
@@ -10,10 +10,38 @@ void Editor::UI::Statistics::DrawRendererStatistics(const std::shared_ptr<Abstra
     ImGui::BulletText("Used Memory: %.2f MB", memoryUsage.usedMemoryMB);
 }
 
+void Editor::UI::Statistics::DrawEntityQueryStatistics(const std::shared_ptr<EntityManager> &entityManager) {
+    const auto statistics = entityManager->GetQueryStatistics();
+
+    ImGui::Text("Entity Queries:");
+    ImGui::Separator();
+    ImGui::BulletText("Cached Queries: %zu", statistics.queryCount);
+    ImGui::BulletText("Hits: %zu", statistics.hits);
+    ImGui::BulletText("Misses: %zu", statistics.misses);
+    ImGui::Text("Maintenance:");
+    ImGui::BulletText("Signature Checks: %zu", statistics.signatureChecks);
+    ImGui::BulletText("Insertions: %zu", statistics.insertions);
+    ImGui::BulletText("Removals: %zu", statistics.removals);
+}
+
+void Editor::UI::Statistics::DrawSceneMemoryStatistics(const std::shared_ptr<Utils::MemoryArena> &memoryArena) {
+    const auto statistics = memoryArena->GetStatistics();
+    constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+
+    ImGui::Text("Scene Memory:");
+    ImGui::Separator();
+    ImGui::BulletText("Reserved: %.2f MB", static_cast<double>(statistics.reservedBytes) / BYTES_PER_MB);
+    ImGui::BulletText("In Use: %.2f MB", static_cast<double>(statistics.usedBytes) / BYTES_PER_MB);
+    ImGui::BulletText("Live Allocations: %zu", statistics.allocationCount);
+    ImGui::BulletText("Total Allocations: %zu", statistics.totalAllocations);
+}
+
 void Editor::UI::Statistics::Draw(const char *title, const VeeEditor *editor) {
     ImGui::Begin(title);
 
     DrawRendererStatistics(editor->GetEngine()->GetRenderer());
+    DrawEntityQueryStatistics(editor->GetScene()->GetEntityManager());
+    DrawSceneMemoryStatistics(editor->GetScene()->GetMemoryArena());
 
     ImGui::End();
 }
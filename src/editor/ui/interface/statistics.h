@@ -13,6 +13,18 @@ namespace Editor::UI {
          */
         static void DrawRendererStatistics(const std::shared_ptr<AbstractRenderer> &renderer);
 
+        /** Draws the cached entity queries statistics UI component.
+         *
+         * @param entityManager
+         */
+        static void DrawEntityQueryStatistics(const std::shared_ptr<EntityManager> &entityManager);
+
+        /** Draws the memory usage of the scene arena.
+         *
+         * @param memoryArena
+         */
+        static void DrawSceneMemoryStatistics(const std::shared_ptr<Utils::MemoryArena> &memoryArena);
+
     public:
         /** Draws the Statistics window.
          *
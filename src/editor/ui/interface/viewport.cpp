@@ -44,7 +44,7 @@ void Editor::UI::Viewport::Draw(const char *title, VeeEditor *editor) {
         const char *label = engine->Paused() ? "Play >" : "Pause ||";
         if (ImGui::Button(label, ImVec2(80, 0))) {
             if (engine->Paused()) {
-                engine->Resume();
+                engine->Play();
             } else {
                 engine->Pause();
             }
@@ -52,6 +52,18 @@ void Editor::UI::Viewport::Draw(const char *title, VeeEditor *editor) {
 
         ImGui::SameLine();
 
+        // Restores the world as it was when play started
+        ImGui::BeginDisabled(!engine->IsPlaying());
+        if (ImGui::Button("Stop", ImVec2(80, 0))) {
+            engine->Stop();
+            if (!engine->GetScene()->GetEntityManager()->IsAlive(editor->GetSelectedEntity())) {
+                editor->SelectEntity(NULL_ENTITY);
+            }
+        }
+        ImGui::EndDisabled();
+
+        ImGui::SameLine();
+
         if (ImGui::Button("Reset")) {
             Command::ReloadCurrentSceneFromFile(editor).Execute();
         }
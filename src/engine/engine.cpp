@@ -1,15 +1,68 @@
 #include "engine.h"
 
+#include <cmath>
+#include <stdexcept>
+
 #include "entities/components_system/components/physics_settings_component.h"
 #include "entities/system/movement_system.h"
+#include "logging/logger.h"
 #include "serialization/scene_serializer.h"
 
-void Engine::Initialize(const std::string &appName, const uint32_t version) const {
+void Engine::Initialize(const std::string &appName, const uint32_t version) {
     m_Renderer->Initialize(appName, version);
+    // GPU transform support is only known once the renderer is initialized.
+    ResolveTransformPropagationMode();
+    if (m_Scene) {
+        ConfigureScene();
+    }
+}
+
+void Engine::RunSystems(const float deltaTime, const std::optional<SystemUpdateRate> rate) const {
+    const auto componentManager = m_Scene->GetComponentManager();
+    const ChangeVersion changeVersion = componentManager->AdvanceChangeVersion();
+
+    m_Scene->GetSystemManager()->UpdateSystems(deltaTime, changeVersion, m_ThreadPool.get(), rate);
+    // Sync point: structural changes recorded by the systems are applied once they have all run.
+    componentManager->PlaybackCommands();
+}
+
+void Engine::Update(const float frameTime) {
+    if (m_Paused) {
+        // Edit mode: systems still run (e.g. transforms follow the inspector), but time does not pass.
+        m_TimeAccumulator = 0.0f;
+        m_InterpolationAlpha = 1.0f;
+        RunSystems(0.0f, std::nullopt);
+        return;
+    }
+
+    m_TimeAccumulator += frameTime;
+    uint32_t subSteps = 0;
+    while (m_TimeAccumulator >= m_FixedTimeStep && subSteps < m_MaxSubSteps) {
+        RunSystems(m_FixedTimeStep, SystemUpdateRate::FixedStep);
+        m_TimeAccumulator -= m_FixedTimeStep;
+        ++subSteps;
+    }
+    if (m_TimeAccumulator >= m_FixedTimeStep) {
+        // Too far behind: the time that could not be simulated is dropped.
+        m_TimeAccumulator = std::fmod(m_TimeAccumulator, m_FixedTimeStep);
+    }
+    m_InterpolationAlpha = m_TimeAccumulator / m_FixedTimeStep;
+
+    RunSystems(frameTime, SystemUpdateRate::EveryFrame);
 }
 
-void Engine::UpdateSystems(const float deltaTime) const {
-    m_Scene->GetSystemManager()->UpdateSystems(m_Paused ? 0.0f : deltaTime);
+void Engine::SetTickRate(const float ticksPerSecond) {
+    if (!(ticksPerSecond > 0.0f)) {
+        throw std::runtime_error("Tick rate must be positive, got " + std::to_string(ticksPerSecond));
+    }
+    m_FixedTimeStep = 1.0f / ticksPerSecond;
+}
+
+void Engine::SetMaxSubSteps(const uint32_t maxSubSteps) {
+    if (maxSubSteps == 0) {
+        throw std::runtime_error("Max sub-steps must be at least 1");
+    }
+    m_MaxSubSteps = maxSubSteps;
 }
 
 void Engine::RegisterSystems(const SystemRegistrationFunction &regFunction) {
@@ -17,11 +70,38 @@ void Engine::RegisterSystems(const SystemRegistrationFunction &regFunction) {
 }
 
 void Engine::PrepareForRendering() const {
-    m_Scene->GetDisplaySystem()->PrepareForRendering(m_ActiveCameraEntityId);
-    m_Renderer->PrepareForRendering();
+    m_Scene->GetDisplaySystem()->PrepareForRendering(m_ActiveCameraEntityId, m_InterpolationAlpha);
+    if (!m_RenderThread) {
+        m_Renderer->PrepareForRendering();
+        m_Renderer->PublishRenderSnapshot();
+    }
+}
+
+void Engine::Render() const {
+    if (m_RenderThread) {
+        // Prepares and publishes the frame once the previous one is drawn.
+        m_RenderThread->SubmitFrame();
+    } else {
+        m_Renderer->Draw();
+    }
+}
+
+void Engine::WaitForRenderThread() const {
+    if (m_RenderThread) {
+        m_RenderThread->Wait();
+    }
+}
+
+void Engine::SetRenderThreadEnabled(const bool enabled) {
+    if (!enabled) {
+        m_RenderThread.reset();
+    } else if (!m_RenderThread) {
+        m_RenderThread = std::make_unique<RenderThread>(m_Renderer);
+    }
 }
 
-void Engine::Shutdown() const {
+void Engine::Shutdown() {
+    m_RenderThread.reset();
     m_Renderer->WaitIdle();
     m_Renderer->Cleanup();
 }
@@ -34,9 +114,32 @@ void Engine::CreateInternalEntities() const {
     componentManager->AddComponent<PhysicsSettingsComponent>(sceneEntity, PhysicsSettingsComponent{});
 }
 
+void Engine::ConfigureScene() const {
+    m_Scene->GetTransformSystem()->SetMode(m_TransformPropagationMode);
+}
+
+void Engine::ResolveTransformPropagationMode() {
+    if (m_TransformPropagationMode == TransformPropagationMode::Gpu && m_Renderer->Initialized() &&
+        !m_Renderer->SupportsGpuTransforms()) {
+        Logger::Warn("The renderer cannot propagate transforms on the GPU, falling back to parallel CPU propagation.");
+        m_TransformPropagationMode = TransformPropagationMode::Parallel;
+    }
+}
+
+void Engine::SetTransformPropagationMode(const TransformPropagationMode mode) {
+    m_TransformPropagationMode = mode;
+    ResolveTransformPropagationMode();
+    if (m_Scene) {
+        ConfigureScene();
+    }
+}
+
 void Engine::LoadScene(const std::string &scenePath) {
+    WaitForRenderThread();
+    m_PlaySnapshot.reset();
     if (m_Renderer->Initialized()) m_Renderer->Reset();
-    m_Scene = SceneSerializer::LoadScene(scenePath, m_Renderer, m_SystemRegistrations);
+    m_Scene = SceneSerializer::LoadScene(scenePath, m_Renderer, m_SystemRegistrations, m_ComponentStorageMode);
+    ConfigureScene();
     CreateInternalEntities();
 }
 
@@ -64,16 +167,58 @@ void Engine::Resume() {
     m_Paused = false;
 }
 
+void Engine::Play() {
+    if (!m_PlaySnapshot) {
+        m_PlaySnapshot = std::make_unique<WorldSnapshot>(m_Scene->CaptureSnapshot());
+    }
+    Resume();
+}
+
+void Engine::Stop() {
+    Pause();
+    if (!m_PlaySnapshot) {
+        return;
+    }
+
+    const auto diff = WorldSnapshot::Diff(*m_PlaySnapshot, m_Scene->CaptureSnapshot());
+    Logger::Info(
+        "Play mode changes: " + std::to_string(diff.created.size()) + " created, " +
+        std::to_string(diff.destroyed.size()) + " destroyed, " +
+        std::to_string(diff.renamed.size()) + " renamed entities; " +
+        std::to_string(diff.added.size()) + " added, " +
+        std::to_string(diff.removed.size()) + " removed, " +
+        std::to_string(diff.modified.size()) + " modified components"
+    );
+
+    m_Scene->RestoreSnapshot(*m_PlaySnapshot);
+    m_PlaySnapshot.reset();
+}
+
 void Engine::Reset() {
-    m_Scene = SceneSerializer::LoadScene(m_Scene->GetPath(), m_Renderer, m_SystemRegistrations);
+    if (m_PlaySnapshot) {
+        Stop();
+        return;
+    }
+    WaitForRenderThread();
+    m_Scene = SceneSerializer::LoadScene(
+        m_Scene->GetPath(),
+        m_Renderer,
+        m_SystemRegistrations,
+        m_ComponentStorageMode
+    );
+    ConfigureScene();
 }
 
 void Engine::NewEmptyScene() {
+    WaitForRenderThread();
+    m_PlaySnapshot.reset();
     if (m_Renderer->Initialized()) m_Renderer->Reset();
     m_Scene = SceneSerializer::LoadScene(
         "../src/editor/assets/scenes/empty.scene",
         m_Renderer,
-        m_SystemRegistrations
+        m_SystemRegistrations,
+        m_ComponentStorageMode
     );
+    ConfigureScene();
     m_Scene->SetPath("");
 }
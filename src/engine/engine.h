@@ -7,18 +7,66 @@
 #include <GLFW/glfw3.h>
 #include <vulkan/vulkan_core.h>
 
+#include "entities/system/transform_system.h"
 #include "renderer/abstract.h"
+#include "renderer/render_thread.h"
 #include "scenes/scene.h"
+#include "utils/threading/thread_pool.h"
 
 class Engine {
+public:
+    static constexpr float DEFAULT_TICK_RATE = 60.0f;
+    static constexpr uint32_t DEFAULT_MAX_SUB_STEPS = 5;
+
+private:
     bool m_ShouldQuit = false;
     bool m_Paused = false;
 
     std::shared_ptr<Scene> m_Scene;
+    /** World captured when play mode started, restored by Stop.
+     */
+    std::unique_ptr<WorldSnapshot> m_PlaySnapshot;
 
     std::shared_ptr<AbstractRenderer> m_Renderer;
+    /** Draws the frames when pipelined rendering is enabled, otherwise frames are drawn by Render.
+     */
+    std::unique_ptr<RenderThread> m_RenderThread;
+    /** Workers used to run independent systems concurrently.
+     */
+    std::shared_ptr<Utils::Threading::ThreadPool> m_ThreadPool = std::make_shared<Utils::Threading::ThreadPool>();
     EntityID m_ActiveCameraEntityId = NULL_ENTITY;
     std::vector<SystemRegistrationFunction> m_SystemRegistrations;
+    ComponentStorageMode m_ComponentStorageMode = ComponentStorageMode::PerType;
+    TransformPropagationMode m_TransformPropagationMode = TransformPropagationMode::Parallel;
+
+    /** Fixed simulation step (see Update), in seconds.
+     */
+    float m_FixedTimeStep = 1.0f / DEFAULT_TICK_RATE;
+    /** Most simulation steps run in one frame, so a slow frame does not cause even slower ones.
+     */
+    uint32_t m_MaxSubSteps = DEFAULT_MAX_SUB_STEPS;
+    /** Frame time not simulated yet, less than one step after each Update.
+     */
+    float m_TimeAccumulator = 0.0f;
+    float m_InterpolationAlpha = 1.0f;
+
+    /** Applies the engine settings to a newly loaded scene.
+     */
+    void ConfigureScene() const;
+
+    /** Falls back from GPU to parallel transform propagation, with a warning, when the initialized renderer
+     *  does not support it. Before initialization, the requested mode is kept.
+     */
+    void ResolveTransformPropagationMode();
+
+    /** Runs the systems of the scene once, restricted to an update rate if one is given, then applies the
+     *  structural changes they recorded.
+     */
+    void RunSystems(float deltaTime, std::optional<SystemUpdateRate> rate) const;
+
+    /** Waits until the render thread (if any) no longer uses the renderer, e.g. before its resources change.
+     */
+    void WaitForRenderThread() const;
 
 public:
     explicit Engine(
@@ -27,15 +75,32 @@ public:
         : m_Renderer(renderer) {
     }
 
-    void Initialize(const std::string &appName, uint32_t version) const;
+    void Initialize(const std::string &appName, uint32_t version);
 
-    void UpdateSystems(float deltaTime) const;
+    /** Advances the scene by the time of one rendered frame.
+     *
+     *  Simulation systems (SystemUpdateRate::FixedStep) run with a fixed time step, as many times as the
+     *  accumulated frame time allows, up to the max sub-steps (the remaining time is then dropped, and the
+     *  simulation runs slower than real time). Per-frame systems (SystemUpdateRate::EveryFrame) then run once
+     *  with the frame time. The time left in the accumulator sets the interpolation alpha used to render
+     *  between the last two steps.
+     *
+     *  While paused, every system runs once with a zero time step, and the last step is rendered.
+     */
+    void Update(float frameTime);
 
     void RegisterSystems(const SystemRegistrationFunction &regFunction);
 
+    /** Records the camera and draw calls of the frame into the renderer's snapshot (see RenderSnapshot).
+     */
     void PrepareForRendering() const;
 
-    void Shutdown() const;
+    /** Draws the recorded frame: right away, or on the render thread when pipelined rendering is enabled, in
+     *  which case this only waits for the previous frame and the caller moves on to the next one.
+     */
+    void Render() const;
+
+    void Shutdown();
 
     void CreateInternalEntities() const;
 
@@ -47,6 +112,10 @@ public:
 
     [[nodiscard]] std::shared_ptr<AbstractRenderer> GetRenderer() const;
 
+    [[nodiscard]] std::shared_ptr<Utils::Threading::ThreadPool> GetThreadPool() const {
+        return m_ThreadPool;
+    }
+
     [[nodiscard]] std::shared_ptr<Scene> GetScene();
 
     void SetActiveCameraEntityId(const EntityID entityId) {
@@ -57,10 +126,80 @@ public:
         return m_ActiveCameraEntityId;
     }
 
+    /** Selects the component storage layout used by scenes loaded from now on.
+     */
+    void SetComponentStorageMode(const ComponentStorageMode mode) {
+        m_ComponentStorageMode = mode;
+    }
+
+    [[nodiscard]] ComponentStorageMode GetComponentStorageMode() const {
+        return m_ComponentStorageMode;
+    }
+
+    /** Selects how the transform system of the current and future scenes propagates transforms. GPU mode falls
+     *  back to parallel when the renderer does not support it, checked here and once the renderer is
+     *  initialized (see Initialize).
+     */
+    void SetTransformPropagationMode(TransformPropagationMode mode);
+
+    [[nodiscard]] TransformPropagationMode GetTransformPropagationMode() const {
+        return m_TransformPropagationMode;
+    }
+
+    /** Sets the number of simulation steps per second (see Update).
+     */
+    void SetTickRate(float ticksPerSecond);
+
+    [[nodiscard]] float GetTickRate() const {
+        return 1.0f / m_FixedTimeStep;
+    }
+
+    [[nodiscard]] float GetFixedTimeStep() const {
+        return m_FixedTimeStep;
+    }
+
+    /** Sets the most simulation steps run in one frame (at least 1).
+     */
+    void SetMaxSubSteps(uint32_t maxSubSteps);
+
+    [[nodiscard]] uint32_t GetMaxSubSteps() const {
+        return m_MaxSubSteps;
+    }
+
+    /** Position of the rendered frame between the previous simulation step (0) and the last one (1).
+     */
+    [[nodiscard]] float GetInterpolationAlpha() const {
+        return m_InterpolationAlpha;
+    }
+
+    /** Pipelined rendering: frames are drawn and presented on a render thread (see RenderThread), while the
+     *  main thread simulates the next one. Not supported by the editor, whose UI is recorded on the main thread.
+     */
+    void SetRenderThreadEnabled(bool enabled);
+
+    [[nodiscard]] bool IsRenderThreadEnabled() const {
+        return m_RenderThread != nullptr;
+    }
+
     void Pause();
 
     void Resume();
 
+    /** Starts play mode: the world is captured (in memory) before the systems resume.
+     */
+    void Play();
+
+    /** Leaves play mode: logs what changed during play, then restores the world captured by Play and pauses.
+     *  Nothing is reloaded from disk and the renderer is left untouched.
+     */
+    void Stop();
+
+    [[nodiscard]] bool IsPlaying() const {
+        return m_PlaySnapshot != nullptr;
+    }
+
+    /** Stops play mode if it is active, otherwise reloads the scene from its file.
+     */
     void Reset();
 
     void NewEmptyScene();
@@ -0,0 +1,219 @@
+#ifndef VEE_ENTITY_COMMAND_BUFFER_H
+#define VEE_ENTITY_COMMAND_BUFFER_H
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "types.h"
+#include "components_system/component_base.h"
+
+namespace Entities {
+    /** Records structural changes (entity creation/destruction, component addition/removal) so that they can
+     * be applied later, in one batch, by ComponentManager::PlaybackCommands.
+     *
+     * Recording is thread-safe: systems running concurrently may share a buffer. Commands are played back
+     * in recording order.
+     *
+     * CreateEntity returns a placeholder handle (generation PENDING_ENTITY_GENERATION) that can be used by
+     * the following commands of the same buffer; it is replaced by the real entity during playback.
+     */
+    class EntityCommandBuffer {
+    public:
+        enum class CommandType : uint8_t {
+            CreateEntity,
+            DestroyEntity,
+            AddComponent,
+            RemoveComponent,
+        };
+
+        struct Command {
+            CommandType type;
+            ComponentTypeId typeId = 0;
+            EntityID entity = NULL_ENTITY;
+            /** Component to move into storage (AddComponent only).
+             */
+            void *component = nullptr;
+            /** Index of the entity name (CreateEntity only).
+             */
+            uint32_t nameIndex = 0;
+        };
+
+    private:
+        static constexpr size_t PAYLOAD_BLOCK_SIZE = 16 * 1024;
+        static constexpr size_t PAYLOAD_ALIGNMENT = 64;
+
+        struct PayloadBlock {
+            struct Deleter {
+                void operator()(std::byte *ptr) const {
+                    ::operator delete[](ptr, std::align_val_t{PAYLOAD_ALIGNMENT});
+                }
+            };
+
+            std::unique_ptr<std::byte[], Deleter> data;
+            size_t size = 0;
+            size_t used = 0;
+        };
+
+        struct PayloadDestructor {
+            void *component;
+            void (*destroy)(void *);
+        };
+
+        std::vector<Command> m_Commands;
+        std::vector<std::string> m_Names;
+        /** Component payloads are stored in blocks that never move, and are reused after Clear.
+         */
+        std::vector<PayloadBlock> m_PayloadBlocks;
+        size_t m_CurrentBlock = 0;
+        std::vector<PayloadDestructor> m_PayloadDestructors;
+        EntityIndex m_PendingEntityCount = 0;
+
+        mutable std::mutex m_Mutex;
+
+        void *AllocatePayload(const size_t size, const size_t alignment) {
+            for (; m_CurrentBlock < m_PayloadBlocks.size(); ++m_CurrentBlock) {
+                auto &block = m_PayloadBlocks[m_CurrentBlock];
+                const size_t offset = (block.used + alignment - 1) / alignment * alignment;
+                if (offset + size <= block.size) {
+                    block.used = offset + size;
+                    return block.data.get() + offset;
+                }
+            }
+
+            PayloadBlock block;
+            block.size = std::max(PAYLOAD_BLOCK_SIZE, size);
+            block.data.reset(static_cast<std::byte *>(
+                ::operator new[](block.size, std::align_val_t{PAYLOAD_ALIGNMENT})
+            ));
+            block.used = size;
+            m_PayloadBlocks.push_back(std::move(block));
+            m_CurrentBlock = m_PayloadBlocks.size() - 1;
+            return m_PayloadBlocks.back().data.get();
+        }
+
+        void DestroyPayloads() {
+            for (const auto &[component, destroy]: m_PayloadDestructors) {
+                destroy(component);
+            }
+            m_PayloadDestructors.clear();
+            for (auto &block: m_PayloadBlocks) {
+                block.used = 0;
+            }
+            m_CurrentBlock = 0;
+        }
+
+    public:
+        EntityCommandBuffer() = default;
+
+        EntityCommandBuffer(const EntityCommandBuffer &) = delete;
+
+        EntityCommandBuffer &operator=(const EntityCommandBuffer &) = delete;
+
+        ~EntityCommandBuffer() {
+            DestroyPayloads();
+        }
+
+        /** Checks whether the handle is a placeholder returned by CreateEntity.
+         */
+        [[nodiscard]] static bool IsPending(const EntityID entity) {
+            return GetEntityGeneration(entity) == PENDING_ENTITY_GENERATION;
+        }
+
+        /** Records the creation of an entity.
+         *
+         * @return A placeholder handle, only meaningful to the commands of this buffer.
+         */
+        EntityID CreateEntity(const std::string &name) {
+            std::lock_guard lock(m_Mutex);
+            if (m_PendingEntityCount > ENTITY_INDEX_MASK) {
+                throw std::runtime_error("Too many pending entities in command buffer");
+            }
+
+            const EntityID placeholder = MakeEntityID(m_PendingEntityCount++, PENDING_ENTITY_GENERATION);
+            m_Commands.push_back({
+                .type = CommandType::CreateEntity,
+                .entity = placeholder,
+                .nameIndex = static_cast<uint32_t>(m_Names.size()),
+            });
+            m_Names.push_back(name);
+            return placeholder;
+        }
+
+        /** Records the destruction of an entity. Internal entities are left untouched at playback.
+         */
+        void DestroyEntity(const EntityID entity) {
+            std::lock_guard lock(m_Mutex);
+            m_Commands.push_back({.type = CommandType::DestroyEntity, .entity = entity});
+        }
+
+        /** Records the addition (or replacement) of a component.
+         */
+        template<typename T>
+        void AddComponent(const EntityID entity, T component) {
+            static_assert(alignof(T) <= PAYLOAD_ALIGNMENT, "Component alignment not supported by command buffers");
+
+            std::lock_guard lock(m_Mutex);
+            void *payload = new(AllocatePayload(sizeof(T), alignof(T))) T(std::move(component));
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                m_PayloadDestructors.push_back({payload, [](void *ptr) { static_cast<T *>(ptr)->~T(); }});
+            }
+            m_Commands.push_back({
+                .type = CommandType::AddComponent,
+                .typeId = ComponentTypeHelper<T>::ID,
+                .entity = entity,
+                .component = payload,
+            });
+        }
+
+        template<typename T>
+        void RemoveComponent(const EntityID entity) {
+            std::lock_guard lock(m_Mutex);
+            m_Commands.push_back({
+                .type = CommandType::RemoveComponent,
+                .typeId = ComponentTypeHelper<T>::ID,
+                .entity = entity,
+            });
+        }
+
+        [[nodiscard]] bool Empty() const {
+            std::lock_guard lock(m_Mutex);
+            return m_Commands.empty();
+        }
+
+        [[nodiscard]] size_t Size() const {
+            std::lock_guard lock(m_Mutex);
+            return m_Commands.size();
+        }
+
+        /** Recorded commands, in recording order. Not synchronized: only call once recording is done.
+         */
+        [[nodiscard]] const std::vector<Command> &GetCommands() const {
+            return m_Commands;
+        }
+
+        [[nodiscard]] const std::string &GetEntityName(const Command &command) const {
+            return m_Names[command.nameIndex];
+        }
+
+        [[nodiscard]] EntityIndex GetPendingEntityCount() const {
+            return m_PendingEntityCount;
+        }
+
+        /** Drops every recorded command and destroys the remaining component payloads.
+         */
+        void Clear() {
+            std::lock_guard lock(m_Mutex);
+            DestroyPayloads();
+            m_Commands.clear();
+            m_Names.clear();
+            m_PendingEntityCount = 0;
+        }
+    };
+}
+
+#endif //VEE_ENTITY_COMMAND_BUFFER_H
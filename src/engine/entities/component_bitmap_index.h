@@ -0,0 +1,129 @@
+#ifndef VEE_COMPONENT_BITMAP_INDEX_H
+#define VEE_COMPONENT_BITMAP_INDEX_H
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "types.h"
+#include "components_system/component_base.h"
+
+namespace Entities {
+    /** Columnar index of entity signatures: one bit-vector per component type, plus one for live entities.
+     *
+     * Bit `i` of a column is set when the entity of index `i` has the component. Matching a signature is
+     * then a matter of ANDing the columns of its components, one block of 256 entities at a time, instead
+     * of comparing a signature per entity. Columns always have the same length, a whole number of blocks.
+     */
+    class ComponentBitmapIndex {
+    public:
+        static constexpr size_t WORD_BITS = 64;
+        static constexpr size_t BLOCK_WORDS = 4;
+        static constexpr size_t BLOCK_BITS = WORD_BITS * BLOCK_WORDS;
+
+        using Block = std::array<uint64_t, BLOCK_WORDS>;
+
+    private:
+        std::array<std::vector<uint64_t>, COMPONENTS_COUNT> m_Columns;
+        std::vector<uint64_t> m_Alive;
+        size_t m_BlockCount = 0;
+
+        void EnsureCapacity(const EntityIndex index) {
+            const size_t requiredBlocks = index / BLOCK_BITS + 1;
+            if (requiredBlocks <= m_BlockCount) {
+                return;
+            }
+
+            m_BlockCount = std::max(requiredBlocks, m_BlockCount * 2);
+            m_Alive.resize(m_BlockCount * BLOCK_WORDS);
+            for (auto &column: m_Columns) {
+                column.resize(m_BlockCount * BLOCK_WORDS);
+            }
+        }
+
+        static void AssignBit(std::vector<uint64_t> &column, const EntityIndex index, const bool value) {
+            const uint64_t bit = uint64_t{1} << (index % WORD_BITS);
+            if (value) {
+                column[index / WORD_BITS] |= bit;
+            } else {
+                column[index / WORD_BITS] &= ~bit;
+            }
+        }
+
+    public:
+        void SetAlive(const EntityIndex index, const bool alive) {
+            EnsureCapacity(index);
+            AssignBit(m_Alive, index, alive);
+        }
+
+        /** Updates the component columns of an entity, only touching the bits that changed.
+         */
+        void UpdateSignature(const EntityIndex index, const Signature &previous, const Signature &current) {
+            const Signature changed = previous ^ current;
+            if (changed.none()) {
+                return;
+            }
+
+            EnsureCapacity(index);
+            for (size_t typeId = 0; typeId < COMPONENTS_COUNT; ++typeId) {
+                if (changed.test(typeId)) {
+                    AssignBit(m_Columns[typeId], index, current.test(typeId));
+                }
+            }
+        }
+
+        /** Clears every bit, keeping the allocated blocks.
+         */
+        void Clear() {
+            std::fill(m_Alive.begin(), m_Alive.end(), 0);
+            for (auto &column: m_Columns) {
+                std::fill(column.begin(), column.end(), 0);
+            }
+        }
+
+        [[nodiscard]] size_t GetBlockCount() const {
+            return m_BlockCount;
+        }
+
+        /** Computes the live entities of a block that have every given component type.
+         *
+         * Bit `b` of word `w` of the result stands for the entity of index `block * BLOCK_BITS + w * WORD_BITS + b`.
+         */
+        void MatchBlock(
+            const size_t block,
+            const ComponentTypeId *types,
+            const size_t typeCount,
+            Block &result
+        ) const {
+            const size_t offset = block * BLOCK_WORDS;
+
+#if defined(__AVX2__)
+            __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(m_Alive.data() + offset));
+            for (size_t i = 0; i < typeCount; ++i) {
+                mask = _mm256_and_si256(
+                    mask,
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i *>(m_Columns[types[i]].data() + offset))
+                );
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(result.data()), mask);
+#else
+            for (size_t word = 0; word < BLOCK_WORDS; ++word) {
+                result[word] = m_Alive[offset + word];
+            }
+            for (size_t i = 0; i < typeCount; ++i) {
+                const uint64_t *column = m_Columns[types[i]].data() + offset;
+                for (size_t word = 0; word < BLOCK_WORDS; ++word) {
+                    result[word] &= column[word];
+                }
+            }
+#endif
+        }
+    };
+}
+
+#endif //VEE_COMPONENT_BITMAP_INDEX_H
@@ -0,0 +1,411 @@
+#include "archetype_storage.h"
+
+#include "component_column.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace Entities {
+    namespace {
+        size_t AlignUp(const size_t value, const size_t alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        /** Computes the column offsets for a chunk holding `capacity` entities.
+         *
+         * @return The total number of bytes required by the chunk.
+         */
+        size_t ComputeLayout(
+            const std::vector<ComponentInfo> &columns,
+            const size_t capacity,
+            std::vector<size_t> &offsets
+        ) {
+            offsets.clear();
+            size_t cursor = AlignUp(capacity * sizeof(EntityID), ARCHETYPE_COLUMN_ALIGNMENT);
+            for (const auto &column: columns) {
+                offsets.push_back(cursor);
+                cursor = AlignUp(cursor + capacity * column.size, ARCHETYPE_COLUMN_ALIGNMENT);
+            }
+            return cursor;
+        }
+    }
+
+    Archetype::Archetype(
+        const Signature &signature,
+        const std::vector<ComponentInfo> &columns,
+        std::pmr::memory_resource *resource
+    ) : m_Resource(resource), m_Signature(signature), m_Columns(columns), m_Chunks(resource) {
+        m_ColumnOfType.fill(-1);
+        for (size_t i = 0; i < m_Columns.size(); ++i) {
+            m_ColumnOfType[m_Columns[i].typeId] = static_cast<int16_t>(i);
+        }
+
+        size_t bytesPerEntity = sizeof(EntityID);
+        for (const auto &column: m_Columns) {
+            bytesPerEntity += column.size;
+        }
+
+        // Start from the ideal capacity and shrink until the padded layout fits in a chunk.
+        size_t capacity = std::max<size_t>(1, ARCHETYPE_CHUNK_SIZE / bytesPerEntity);
+        size_t byteSize = ComputeLayout(m_Columns, capacity, m_ColumnOffsets);
+        while (capacity > 1 && byteSize > ARCHETYPE_CHUNK_SIZE) {
+            byteSize = ComputeLayout(m_Columns, --capacity, m_ColumnOffsets);
+        }
+
+        m_ChunkCapacity = capacity;
+        m_ChunkByteSize = std::max(byteSize, ARCHETYPE_CHUNK_SIZE);
+    }
+
+    Archetype::~Archetype() {
+        Clear();
+    }
+
+    void Archetype::Clear() {
+        for (auto &chunk: m_Chunks) {
+            for (size_t column = 0; column < m_Columns.size(); ++column) {
+                for (size_t row = 0; row < chunk.m_Count; ++row) {
+                    m_Columns[column].destroy(GetSlot(chunk, column, row));
+                }
+            }
+        }
+        m_Chunks.clear();
+    }
+
+    std::pair<uint32_t, uint32_t> Archetype::AllocateRow(const EntityID entity, const ChangeVersion version) {
+        if (m_Chunks.empty() || m_Chunks.back().m_Count == m_ChunkCapacity) {
+            m_Chunks.emplace_back(m_ChunkByteSize, m_Columns.size(), m_Resource);
+        }
+
+        auto &chunk = m_Chunks.back();
+        const auto row = chunk.m_Count++;
+        GetEntities(chunk)[row] = entity;
+        MarkAllChanged(chunk, version);
+
+        return {static_cast<uint32_t>(m_Chunks.size() - 1), static_cast<uint32_t>(row)};
+    }
+
+    EntityID Archetype::RemoveRow(const uint32_t chunkIndex, const uint32_t row, const ChangeVersion version) {
+        auto &chunk = m_Chunks[chunkIndex];
+        auto &lastChunk = m_Chunks.back();
+        const size_t lastRow = lastChunk.m_Count - 1;
+        const bool isLast = &chunk == &lastChunk && row == lastRow;
+
+        EntityID movedEntity = NULL_ENTITY;
+        for (size_t column = 0; column < m_Columns.size(); ++column) {
+            const auto &info = m_Columns[column];
+            info.destroy(GetSlot(chunk, column, row));
+            if (!isLast) {
+                void *last = GetSlot(lastChunk, column, lastRow);
+                info.moveConstruct(GetSlot(chunk, column, row), last, m_Resource);
+                info.destroy(last);
+            }
+        }
+
+        if (!isLast) {
+            movedEntity = GetEntities(lastChunk)[lastRow];
+            GetEntities(chunk)[row] = movedEntity;
+            MarkAllChanged(chunk, version);
+        }
+
+        if (--lastChunk.m_Count == 0) {
+            m_Chunks.pop_back();
+        }
+
+        return movedEntity;
+    }
+
+    void ArchetypeStorage::RegisterComponent(const ComponentInfo &info) {
+        m_ComponentInfos[info.typeId] = info;
+        m_RegisteredComponents.set(info.typeId);
+    }
+
+    Archetype *ArchetypeStorage::GetOrCreateArchetype(const Signature &signature) {
+        if (const auto it = m_ArchetypeMap.find(signature); it != m_ArchetypeMap.end()) {
+            return it->second.get();
+        }
+
+        std::vector<ComponentInfo> columns;
+        for (size_t typeId = 0; typeId < COMPONENTS_COUNT; ++typeId) {
+            if (signature.test(typeId)) {
+                columns.push_back(m_ComponentInfos[typeId]);
+            }
+        }
+
+        auto archetype = std::make_unique<Archetype>(signature, columns, m_Resource);
+        const auto archetypePtr = archetype.get();
+        m_ArchetypeMap.emplace(signature, std::move(archetype));
+        m_Archetypes.push_back(archetypePtr);
+        return archetypePtr;
+    }
+
+    Archetype *ArchetypeStorage::GetArchetypeWith(Archetype *from, const ComponentTypeId typeId) {
+        if (from == nullptr) {
+            Signature signature;
+            signature.set(typeId);
+            return GetOrCreateArchetype(signature);
+        }
+        if (from->m_AddEdges[typeId] == nullptr) {
+            auto signature = from->GetSignature();
+            signature.set(typeId);
+            from->m_AddEdges[typeId] = GetOrCreateArchetype(signature);
+        }
+        return from->m_AddEdges[typeId];
+    }
+
+    Archetype *ArchetypeStorage::GetArchetypeWithout(Archetype *from, const ComponentTypeId typeId) {
+        auto signature = from->GetSignature();
+        signature.reset(typeId);
+        if (signature.none()) {
+            return nullptr;
+        }
+        if (from->m_RemoveEdges[typeId] == nullptr) {
+            from->m_RemoveEdges[typeId] = GetOrCreateArchetype(signature);
+        }
+        return from->m_RemoveEdges[typeId];
+    }
+
+    void ArchetypeStorage::MoveEntity(const EntityID entity, Archetype *target, const ChangeVersion version) {
+        auto &location = m_Locations[GetEntityIndex(entity)];
+        Archetype *source = location.archetype;
+
+        EntityLocation newLocation{target, 0, 0};
+        if (target != nullptr) {
+            const auto [chunk, row] = target->AllocateRow(entity, version);
+            newLocation.chunk = chunk;
+            newLocation.row = row;
+
+            if (source != nullptr) {
+                for (const auto &info: source->GetColumns()) {
+                    if (target->HasColumn(info.typeId)) {
+                        info.moveConstruct(
+                            target->GetComponent(info.typeId, chunk, row),
+                            source->GetComponent(info.typeId, location.chunk, location.row),
+                            m_Resource
+                        );
+                    }
+                }
+            }
+        }
+
+        if (source != nullptr) {
+            if (const auto moved = source->RemoveRow(location.chunk, location.row, version); moved != NULL_ENTITY) {
+                m_Locations[GetEntityIndex(moved)].chunk = location.chunk;
+                m_Locations[GetEntityIndex(moved)].row = location.row;
+            }
+        }
+
+        location = newLocation;
+    }
+
+    void *ArchetypeStorage::InsertUninitialized(
+        const ComponentTypeId typeId,
+        const EntityID entity,
+        const ChangeVersion version
+    ) {
+        if (!m_RegisteredComponents.test(typeId)) {
+            throw std::runtime_error("Component type not registered in archetype storage: " + std::to_string(typeId));
+        }
+        const EntityIndex index = GetEntityIndex(entity);
+        if (index >= m_Locations.size()) {
+            m_Locations.resize(index + 1);
+        }
+
+        MoveEntity(entity, GetArchetypeWith(m_Locations[index].archetype, typeId), version);
+
+        const auto &[archetype, chunk, row] = m_Locations[index];
+        return archetype->GetComponent(typeId, chunk, row);
+    }
+
+    void ArchetypeStorage::InsertDefaultEntities(
+        const std::vector<EntityID> &entities,
+        const Signature &signature,
+        const ChangeVersion version
+    ) {
+        InsertCopiedEntities(entities, signature, {}, version);
+    }
+
+    void ArchetypeStorage::InsertCopiedEntities(
+        const std::vector<EntityID> &entities,
+        const Signature &signature,
+        const std::array<const void *, COMPONENTS_COUNT> &components,
+        const ChangeVersion version
+    ) {
+        if ((signature & ~m_RegisteredComponents).any()) {
+            throw std::runtime_error("Component type not registered in archetype storage: " + signature.to_string());
+        }
+        if (signature.none() || entities.empty()) {
+            return;
+        }
+
+        Archetype *archetype = GetOrCreateArchetype(signature);
+
+        EntityIndex maxIndex = 0;
+        for (const auto entity: entities) {
+            maxIndex = std::max(maxIndex, GetEntityIndex(entity));
+        }
+        if (maxIndex >= m_Locations.size()) {
+            m_Locations.resize(maxIndex + 1);
+        }
+
+        for (const auto entity: entities) {
+            const auto [chunk, row] = archetype->AllocateRow(entity, version);
+            for (const auto &info: archetype->GetColumns()) {
+                void *slot = archetype->GetComponent(info.typeId, chunk, row);
+                if (const void *source = components[info.typeId]) {
+                    info.CopyConstruct(slot, source, m_Resource);
+                } else {
+                    info.defaultConstruct(slot, m_Resource);
+                }
+            }
+            m_Locations[GetEntityIndex(entity)] = {archetype, chunk, row};
+        }
+    }
+
+    void ArchetypeStorage::InsertDefault(const ComponentTypeId typeId, const EntityID entity, const ChangeVersion version) {
+        if (Has(typeId, entity)) {
+            return;
+        }
+        m_ComponentInfos[typeId].defaultConstruct(InsertUninitialized(typeId, entity, version), m_Resource);
+    }
+
+    void ArchetypeStorage::InsertMoved(
+        const ComponentTypeId typeId,
+        const EntityID entity,
+        void *component,
+        const ChangeVersion version
+    ) {
+        const auto &info = m_ComponentInfos[typeId];
+        if (Has(typeId, entity)) {
+            const auto &[archetype, chunk, row] = m_Locations[GetEntityIndex(entity)];
+            void *slot = archetype->GetComponent(typeId, chunk, row);
+            info.destroy(slot);
+            info.moveConstruct(slot, component, m_Resource);
+            archetype->MarkChanged(archetype->m_Chunks[chunk], typeId, version);
+            return;
+        }
+        info.moveConstruct(InsertUninitialized(typeId, entity, version), component, m_Resource);
+    }
+
+    std::vector<ComponentTypeId> ArchetypeStorage::GetComponentTypes(const EntityID entity) const {
+        std::vector<ComponentTypeId> types;
+        if (const auto location = GetLocation(entity)) {
+            for (const auto &info: location->archetype->GetColumns()) {
+                types.push_back(info.typeId);
+            }
+        }
+        return types;
+    }
+
+    void ArchetypeStorage::Remove(const ComponentTypeId typeId, const EntityID entity, const ChangeVersion version) {
+        if (!Has(typeId, entity)) {
+            return;
+        }
+        MoveEntity(entity, GetArchetypeWithout(m_Locations[GetEntityIndex(entity)].archetype, typeId), version);
+    }
+
+    void ArchetypeStorage::RemoveEntity(const EntityID entity, const ChangeVersion version) {
+        if (entity == NULL_ENTITY) {
+            throw std::runtime_error("Trying to remove NULL_ENTITY from ArchetypeStorage");
+        }
+        if (GetLocation(entity) == nullptr) {
+            return;
+        }
+        MoveEntity(entity, nullptr, version);
+    }
+
+    void ArchetypeStorage::Capture(
+        std::array<ComponentSnapshot, COMPONENTS_COUNT> &components,
+        std::vector<std::pair<Signature, size_t> > &archetypes
+    ) const {
+        for (const auto archetype: m_Archetypes) {
+            size_t count = 0;
+            for (const auto &chunk: archetype->m_Chunks) {
+                count += chunk.m_Count;
+            }
+            if (count == 0) {
+                continue;
+            }
+            archetypes.emplace_back(archetype->GetSignature(), count);
+
+            for (size_t column = 0; column < archetype->m_Columns.size(); ++column) {
+                const auto &info = archetype->m_Columns[column];
+                auto &snapshot = components[info.typeId];
+                snapshot.Reserve(info, count);
+                for (auto &chunk: archetype->m_Chunks) {
+                    const EntityID *entities = archetype->GetEntities(chunk);
+                    snapshot.entities.insert(snapshot.entities.end(), entities, entities + chunk.m_Count);
+                    snapshot.versions.insert(snapshot.versions.end(), chunk.m_Count, chunk.m_ChangeVersions[column]);
+                    snapshot.components->PushRange(archetype->GetSlot(chunk, column, 0), chunk.m_Count);
+                }
+            }
+        }
+    }
+
+    void ArchetypeStorage::Restore(
+        const std::array<ComponentSnapshot, COMPONENTS_COUNT> &components,
+        const std::vector<std::pair<Signature, size_t> > &archetypes,
+        const ChangeVersion version
+    ) {
+        for (const auto archetype: m_Archetypes) {
+            archetype->Clear();
+        }
+        std::fill(m_Locations.begin(), m_Locations.end(), EntityLocation{});
+
+        // Rows of every type are laid out archetype after archetype: each archetype consumes the next
+        // `count` rows of each of its columns.
+        std::array<size_t, COMPONENTS_COUNT> cursors{};
+        for (const auto &[signature, count]: archetypes) {
+            if ((signature & ~m_RegisteredComponents).any()) {
+                throw std::runtime_error("Component type not registered in archetype storage: " + signature.to_string());
+            }
+            Archetype *archetype = GetOrCreateArchetype(signature);
+            const auto &columns = archetype->GetColumns();
+            const EntityID *entities = components[columns.front().typeId].entities.data()
+                                       + cursors[columns.front().typeId];
+
+            EntityIndex maxIndex = 0;
+            for (size_t i = 0; i < count; ++i) {
+                maxIndex = std::max(maxIndex, GetEntityIndex(entities[i]));
+            }
+            if (maxIndex >= m_Locations.size()) {
+                m_Locations.resize(maxIndex + 1);
+            }
+
+            for (size_t done = 0; done < count;) {
+                auto &chunks = archetype->m_Chunks;
+                if (chunks.empty() || chunks.back().m_Count == archetype->m_ChunkCapacity) {
+                    chunks.emplace_back(archetype->m_ChunkByteSize, columns.size(), m_Resource);
+                }
+                auto &chunk = chunks.back();
+                const auto chunkIndex = static_cast<uint32_t>(chunks.size() - 1);
+                const size_t firstRow = chunk.m_Count;
+                const size_t run = std::min(count - done, archetype->m_ChunkCapacity - firstRow);
+
+                std::copy_n(entities + done, run, archetype->GetEntities(chunk) + firstRow);
+                for (size_t column = 0; column < columns.size(); ++column) {
+                    const auto &info = columns[column];
+                    const auto &source = *components[info.typeId].components;
+                    info.CopyConstructRange(
+                        archetype->GetSlot(chunk, column, firstRow),
+                        source.Get(cursors[info.typeId] + done),
+                        run,
+                        m_Resource
+                    );
+                }
+                chunk.m_Count += run;
+                Archetype::MarkAllChanged(chunk, version);
+
+                for (size_t row = 0; row < run; ++row) {
+                    m_Locations[GetEntityIndex(entities[done + row])] = {
+                        archetype, chunkIndex, static_cast<uint32_t>(firstRow + row)
+                    };
+                }
+                done += run;
+            }
+
+            for (const auto &info: columns) {
+                cursors[info.typeId] += count;
+            }
+        }
+    }
+}
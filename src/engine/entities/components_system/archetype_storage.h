@@ -0,0 +1,454 @@
+#ifndef VEE_ARCHETYPE_STORAGE_H
+#define VEE_ARCHETYPE_STORAGE_H
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "../types.h"
+#include "component_base.h"
+
+namespace Entities {
+    struct ComponentSnapshot;
+
+    /** Size in bytes of a single archetype chunk.
+     */
+    constexpr size_t ARCHETYPE_CHUNK_SIZE = 16 * 1024;
+
+    /** Alignment of every chunk and of every column inside a chunk (one cache line).
+     */
+    constexpr size_t ARCHETYPE_COLUMN_ALIGNMENT = 64;
+
+    /** Type-erased description of a component type.
+     *
+     * Archetype storage only knows components through this table, which is enough to construct,
+     * relocate and destroy them when an entity moves from one archetype to another.
+     *
+     * Components are constructed with uses-allocator construction: allocator-aware components allocate
+     * their own containers from the given memory resource, the others ignore it.
+     */
+    struct ComponentInfo {
+        ComponentTypeId typeId = 0;
+        size_t size = 0;
+        size_t alignment = 0;
+        /** Copies can be made with memcpy.
+         */
+        bool triviallyCopyable = false;
+
+        void (*defaultConstruct)(void *dst, std::pmr::memory_resource *resource) = nullptr;
+        void (*copyConstruct)(void *dst, const void *src, std::pmr::memory_resource *resource) = nullptr;
+        void (*moveConstruct)(void *dst, void *src, std::pmr::memory_resource *resource) = nullptr;
+        void (*destroy)(void *ptr) = nullptr;
+
+        template<typename T>
+        static ComponentInfo Of() {
+            using Allocator = std::pmr::polymorphic_allocator<>;
+            return {
+                .typeId = ComponentTypeHelper<T>::ID,
+                .size = sizeof(T),
+                .alignment = alignof(T),
+                .triviallyCopyable = std::is_trivially_copyable_v<T>,
+                .defaultConstruct = [](void *dst, std::pmr::memory_resource *resource) {
+                    std::uninitialized_construct_using_allocator(static_cast<T *>(dst), Allocator(resource));
+                },
+                .copyConstruct = [](void *dst, const void *src, std::pmr::memory_resource *resource) {
+                    std::uninitialized_construct_using_allocator(
+                        static_cast<T *>(dst), Allocator(resource), *static_cast<const T *>(src)
+                    );
+                },
+                .moveConstruct = [](void *dst, void *src, std::pmr::memory_resource *resource) {
+                    std::uninitialized_construct_using_allocator(
+                        static_cast<T *>(dst), Allocator(resource), std::move(*static_cast<T *>(src))
+                    );
+                },
+                .destroy = [](void *ptr) { static_cast<T *>(ptr)->~T(); },
+            };
+        }
+
+        /** Copy-constructs `src` into `dst`, with a plain memcpy for trivially copyable components.
+         */
+        void CopyConstruct(void *dst, const void *src, std::pmr::memory_resource *resource) const {
+            if (triviallyCopyable) {
+                std::memcpy(dst, src, size);
+            } else {
+                copyConstruct(dst, src, resource);
+            }
+        }
+
+        /** Copy-constructs `count` contiguous components, with a single memcpy for trivially copyable ones.
+         */
+        void CopyConstructRange(
+            void *dst,
+            const void *src,
+            const size_t count,
+            std::pmr::memory_resource *resource
+        ) const {
+            if (triviallyCopyable) {
+                std::memcpy(dst, src, count * size);
+                return;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                copyConstruct(
+                    static_cast<std::byte *>(dst) + i * size,
+                    static_cast<const std::byte *>(src) + i * size,
+                    resource
+                );
+            }
+        }
+    };
+
+    /** Fixed-size block of memory holding up to `Archetype::GetChunkCapacity()` entities.
+     *
+     * Layout: [EntityID x capacity][column 0 x capacity][column 1 x capacity]...
+     * Each column starts on a cache line boundary.
+     *
+     * The chunk also keeps, per column, the ChangeVersion of the last write to any of its rows.
+     */
+    class ArchetypeChunk {
+        struct Deleter {
+            std::pmr::memory_resource *resource;
+            size_t byteSize;
+
+            void operator()(std::byte *ptr) const {
+                resource->deallocate(ptr, byteSize, ARCHETYPE_COLUMN_ALIGNMENT);
+            }
+        };
+
+        std::unique_ptr<std::byte[], Deleter> m_Data;
+        size_t m_Count = 0;
+        std::pmr::vector<ChangeVersion> m_ChangeVersions;
+
+        friend class Archetype;
+        friend class ArchetypeStorage;
+
+    public:
+        ArchetypeChunk(const size_t byteSize, const size_t columnCount, std::pmr::memory_resource *resource)
+            : m_Data(
+                  static_cast<std::byte *>(resource->allocate(byteSize, ARCHETYPE_COLUMN_ALIGNMENT)),
+                  Deleter{resource, byteSize}
+              ), m_ChangeVersions(columnCount, 0, resource) {
+        }
+
+        /** Number of live entities stored in this chunk.
+         */
+        [[nodiscard]] size_t Count() const {
+            return m_Count;
+        }
+    };
+
+    /** Storage for every entity sharing the exact same signature.
+     */
+    class Archetype {
+        std::pmr::memory_resource *m_Resource;
+        Signature m_Signature;
+        std::vector<ComponentInfo> m_Columns;
+        std::vector<size_t> m_ColumnOffsets;
+        std::array<int16_t, COMPONENTS_COUNT> m_ColumnOfType{};
+
+        size_t m_ChunkCapacity = 0;
+        size_t m_ChunkByteSize = 0;
+        std::pmr::vector<ArchetypeChunk> m_Chunks;
+
+        /** Cached transitions to the archetype obtained by adding / removing a component type.
+         */
+        std::array<Archetype *, COMPONENTS_COUNT> m_AddEdges{};
+        std::array<Archetype *, COMPONENTS_COUNT> m_RemoveEdges{};
+
+        friend class ArchetypeStorage;
+
+        [[nodiscard]] void *GetSlot(ArchetypeChunk &chunk, const size_t column, const size_t row) const {
+            return chunk.m_Data.get() + m_ColumnOffsets[column] + row * m_Columns[column].size;
+        }
+
+        static void MarkAllChanged(ArchetypeChunk &chunk, const ChangeVersion version) {
+            std::fill(chunk.m_ChangeVersions.begin(), chunk.m_ChangeVersions.end(), version);
+        }
+
+        /** Destroys every stored component and releases the chunks.
+         */
+        void Clear();
+
+    public:
+        Archetype(
+            const Signature &signature,
+            const std::vector<ComponentInfo> &columns,
+            std::pmr::memory_resource *resource
+        );
+
+        Archetype(const Archetype &) = delete;
+
+        Archetype &operator=(const Archetype &) = delete;
+
+        ~Archetype();
+
+        [[nodiscard]] const Signature &GetSignature() const {
+            return m_Signature;
+        }
+
+        [[nodiscard]] size_t GetChunkCapacity() const {
+            return m_ChunkCapacity;
+        }
+
+        [[nodiscard]] std::pmr::vector<ArchetypeChunk> &GetChunks() {
+            return m_Chunks;
+        }
+
+        [[nodiscard]] const std::vector<ComponentInfo> &GetColumns() const {
+            return m_Columns;
+        }
+
+        [[nodiscard]] bool HasColumn(const ComponentTypeId typeId) const {
+            return m_ColumnOfType[typeId] >= 0;
+        }
+
+        /** Returns the entity IDs stored in the given chunk, indexed by row.
+         */
+        [[nodiscard]] EntityID *GetEntities(ArchetypeChunk &chunk) const {
+            return reinterpret_cast<EntityID *>(chunk.m_Data.get());
+        }
+
+        /** Returns the contiguous column of components of type T stored in the given chunk.
+         */
+        template<typename T>
+        [[nodiscard]] T *GetColumn(ArchetypeChunk &chunk) const {
+            const auto column = m_ColumnOfType[ComponentTypeHelper<T>::ID];
+            return reinterpret_cast<T *>(chunk.m_Data.get() + m_ColumnOffsets[column]);
+        }
+
+        /** Returns the address of the component of the given type stored at (chunk, row).
+         */
+        [[nodiscard]] void *GetComponent(const ComponentTypeId typeId, const size_t chunk, const size_t row) {
+            return GetSlot(m_Chunks[chunk], m_ColumnOfType[typeId], row);
+        }
+
+        /** Version of the last write to the column of the given type in the chunk.
+         */
+        [[nodiscard]] ChangeVersion GetChangeVersion(const ArchetypeChunk &chunk, const ComponentTypeId typeId) const {
+            return chunk.m_ChangeVersions[m_ColumnOfType[typeId]];
+        }
+
+        /** Records a write to the column of the given type in the chunk.
+         */
+        void MarkChanged(ArchetypeChunk &chunk, const ComponentTypeId typeId, const ChangeVersion version) const {
+            chunk.m_ChangeVersions[m_ColumnOfType[typeId]] = version;
+        }
+
+        /** Reserves a row for the entity at the end of the last chunk.
+         * Components of the new row are left unconstructed, and every column of the chunk is marked as changed.
+         *
+         * @return The (chunk, row) pair of the new row.
+         */
+        std::pair<uint32_t, uint32_t> AllocateRow(EntityID entity, ChangeVersion version);
+
+        /** Destroys the components stored at (chunk, row) and fills the hole with the last row, marking
+         * every column of the chunk as changed.
+         *
+         * @return The entity that was moved into the hole, or NULL_ENTITY if the removed row was the last one.
+         */
+        EntityID RemoveRow(uint32_t chunk, uint32_t row, ChangeVersion version);
+    };
+
+    /** Physical location of an entity inside archetype storage, indexed by entity index.
+     */
+    struct EntityLocation {
+        Archetype *archetype = nullptr;
+        uint32_t chunk = 0;
+        uint32_t row = 0;
+    };
+
+    /** Component storage grouping entities by signature.
+     *
+     * Every entity lives in exactly one archetype (the one matching its component set) and its
+     * components are stored column by column inside fixed-size chunks, so iterating a set of
+     * components streams through contiguous memory instead of looking each entity up in a map.
+     *
+     * Writes are tracked per chunk and column: operations taking a ChangeVersion stamp the columns
+     * they touch (structural changes stamp every column of the affected chunks).
+     *
+     * Chunks and entity locations are allocated from the memory resource given at construction.
+     */
+    class ArchetypeStorage {
+        std::pmr::memory_resource *m_Resource;
+        std::array<ComponentInfo, COMPONENTS_COUNT> m_ComponentInfos{};
+        Signature m_RegisteredComponents;
+
+        std::unordered_map<Signature, std::unique_ptr<Archetype> > m_ArchetypeMap;
+        std::vector<Archetype *> m_Archetypes;
+        std::pmr::vector<EntityLocation> m_Locations;
+
+        Archetype *GetOrCreateArchetype(const Signature &signature);
+
+        Archetype *GetArchetypeWith(Archetype *from, ComponentTypeId typeId);
+
+        Archetype *GetArchetypeWithout(Archetype *from, ComponentTypeId typeId);
+
+        /** Moves the entity to the given archetype, relocating the components both archetypes share.
+         */
+        void MoveEntity(EntityID entity, Archetype *target, ChangeVersion version);
+
+        /** Moves the entity into an archetype containing the given type and returns
+         * the (unconstructed) slot where the new component must be constructed.
+         */
+        void *InsertUninitialized(ComponentTypeId typeId, EntityID entity, ChangeVersion version);
+
+        [[nodiscard]] const EntityLocation *GetLocation(const EntityID entity) const {
+            const EntityIndex index = GetEntityIndex(entity);
+            if (index >= m_Locations.size() || m_Locations[index].archetype == nullptr) {
+                return nullptr;
+            }
+            const auto &location = m_Locations[index];
+            // Reject stale handles whose index has been reused by another entity.
+            if (location.archetype->GetEntities(location.archetype->m_Chunks[location.chunk])[location.row] != entity) {
+                return nullptr;
+            }
+            return &location;
+        }
+
+        /** Location of an entity owning a component of the given type.
+         *
+         *  @throws std::runtime_error if the entity is not stored or has no such component.
+         */
+        [[nodiscard]] const EntityLocation &GetExistingLocation(
+            const ComponentTypeId typeId,
+            const EntityID entity
+        ) const {
+            const auto location = GetLocation(entity);
+            if (location == nullptr || !location->archetype->HasColumn(typeId)) {
+                throw std::runtime_error("Retrieving non-existent component.");
+            }
+            return *location;
+        }
+
+    public:
+        explicit ArchetypeStorage(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : m_Resource(resource), m_Locations(resource) {
+        }
+
+        void RegisterComponent(const ComponentInfo &info);
+
+        /** Stores entities that have no component yet directly in the archetype of `signature`, with
+         *  default-constructed components (a single row allocation per entity, no intermediate archetypes).
+         */
+        void InsertDefaultEntities(const std::vector<EntityID> &entities, const Signature &signature, ChangeVersion version);
+
+        /** Same as InsertDefaultEntities, but the components whose type has a non-null entry in `components`
+         *  are copied from it instead of being default-constructed.
+         */
+        void InsertCopiedEntities(
+            const std::vector<EntityID> &entities,
+            const Signature &signature,
+            const std::array<const void *, COMPONENTS_COUNT> &components,
+            ChangeVersion version
+        );
+
+        template<typename T>
+        void Insert(const EntityID entity, const T &component, const ChangeVersion version) {
+            if (Has(ComponentTypeHelper<T>::ID, entity)) {
+                Get<T>(entity, version) = component;
+                return;
+            }
+            std::uninitialized_construct_using_allocator(
+                static_cast<T *>(InsertUninitialized(ComponentTypeHelper<T>::ID, entity, version)),
+                std::pmr::polymorphic_allocator<>(m_Resource),
+                component
+            );
+        }
+
+        void InsertDefault(ComponentTypeId typeId, EntityID entity, ChangeVersion version);
+
+        /** Inserts (or overwrites) a component by moving from `component`, which must point to an object
+         *  of the registered type.
+         */
+        void InsertMoved(ComponentTypeId typeId, EntityID entity, void *component, ChangeVersion version);
+
+        /** Returns the component of the entity, whose column is marked as changed at `version`.
+         */
+        template<typename T>
+        T &Get(const EntityID entity, const ChangeVersion version) {
+            const auto &[archetype, chunk, row] = GetExistingLocation(ComponentTypeHelper<T>::ID, entity);
+            archetype->MarkChanged(archetype->m_Chunks[chunk], ComponentTypeHelper<T>::ID, version);
+            return *static_cast<T *>(archetype->GetComponent(ComponentTypeHelper<T>::ID, chunk, row));
+        }
+
+        /** Returns the component of the entity without marking it as changed.
+         */
+        template<typename T>
+        [[nodiscard]] const T &Get(const EntityID entity) const {
+            const auto &[archetype, chunk, row] = GetExistingLocation(ComponentTypeHelper<T>::ID, entity);
+            return *static_cast<const T *>(archetype->GetComponent(ComponentTypeHelper<T>::ID, chunk, row));
+        }
+
+        /** Returns the address of the component of the given type owned by the entity, or nullptr.
+         */
+        [[nodiscard]] const void *GetDataPointer(const ComponentTypeId typeId, const EntityID entity) const {
+            const auto location = GetLocation(entity);
+            if (location == nullptr || !location->archetype->HasColumn(typeId)) {
+                return nullptr;
+            }
+            return location->archetype->GetComponent(typeId, location->chunk, location->row);
+        }
+
+        [[nodiscard]] bool Has(const ComponentTypeId typeId, const EntityID entity) const {
+            const auto location = GetLocation(entity);
+            return location && location->archetype->HasColumn(typeId);
+        }
+
+        /** Returns the component types stored for the entity, in column order.
+         */
+        [[nodiscard]] std::vector<ComponentTypeId> GetComponentTypes(EntityID entity) const;
+
+        void Remove(ComponentTypeId typeId, EntityID entity, ChangeVersion version);
+
+        void RemoveEntity(EntityID entity, ChangeVersion version);
+
+        /** Calls `func(Archetype &, ArchetypeChunk &)` for every non-empty chunk whose archetype
+         * contains all the components of the given signature.
+         */
+        template<typename Func>
+        void ForEachChunk(const Signature &signature, Func &&func) {
+            for (const auto archetype: m_Archetypes) {
+                if ((archetype->GetSignature() & signature) != signature) {
+                    continue;
+                }
+                for (auto &chunk: archetype->GetChunks()) {
+                    if (chunk.Count() > 0) {
+                        func(*archetype, chunk);
+                    }
+                }
+            }
+        }
+
+        [[nodiscard]] size_t GetArchetypeCount() const {
+            return m_Archetypes.size();
+        }
+
+        /** Copies every stored component into `components`, indexed by type, archetype after archetype.
+         *  The signature and entity count of each non-empty archetype are appended to `archetypes`, in the
+         *  same order, so that Restore can rebuild the chunks without looking entities up.
+         *
+         *  Row versions are the versions of the chunk columns they come from.
+         */
+        void Capture(
+            std::array<ComponentSnapshot, COMPONENTS_COUNT> &components,
+            std::vector<std::pair<Signature, size_t> > &archetypes
+        ) const;
+
+        /** Replaces the whole content with a capture, copying column ranges chunk by chunk. Every restored
+         *  chunk is marked as changed at `version`.
+         */
+        void Restore(
+            const std::array<ComponentSnapshot, COMPONENTS_COUNT> &components,
+            const std::vector<std::pair<Signature, size_t> > &archetypes,
+            ChangeVersion version
+        );
+    };
+}
+
+#endif //VEE_ARCHETYPE_STORAGE_H
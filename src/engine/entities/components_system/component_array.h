@@ -1,10 +1,13 @@
 #ifndef VEE_COMPONENT_ARRAY_H
 #define VEE_COMPONENT_ARRAY_H
-#include <unordered_map>
+#include <memory_resource>
+#include <stdexcept>
 #include <vector>
 
+#include "../sparse_set.h"
 #include "../types.h"
 #include "component_base.h"
+#include "component_column.h"
 
 namespace Entities {
     class IComponentArray {
@@ -13,7 +16,30 @@ namespace Entities {
 
         [[nodiscard]] virtual bool HasData(EntityID entity) const = 0;
 
-        virtual void InsertDefault(EntityID entity) = 0;
+        virtual void InsertDefault(EntityID entity, ChangeVersion version) = 0;
+
+        /** Inserts (or overwrites) the component of the entity by moving from `component`,
+         *  which must point to an object of the stored type.
+         */
+        virtual void InsertMoved(EntityID entity, void *component, ChangeVersion version) = 0;
+
+        /** Gives every entity (none of which may own the component yet) a copy of `component`,
+         *  which must point to an object of the stored type.
+         */
+        virtual void InsertCopies(const std::vector<EntityID> &entities, const void *component, ChangeVersion version) = 0;
+
+        /** Returns the address of the component owned by the entity, or nullptr.
+         */
+        [[nodiscard]] virtual const void *GetDataPointer(EntityID entity) const = 0;
+
+        /** Copies every stored component, with its owner and write version, into `snapshot`.
+         */
+        virtual void Capture(ComponentSnapshot &snapshot) const = 0;
+
+        /** Replaces the whole content with the components of a snapshot taken by Capture, all marked as
+         *  changed at `version`.
+         */
+        virtual void Restore(const ComponentSnapshot &snapshot, ChangeVersion version) = 0;
 
         virtual ~IComponentArray() = default;
 
@@ -21,49 +47,56 @@ namespace Entities {
     };
 
 
+    /** Packed storage for all components of type T, indexed through a sparse set.
+     *
+     * Components are kept contiguous in the same order as the dense entity array of the set,
+     * so lookups are two array loads and iteration is a linear walk.
+     *
+     * Every component carries the ChangeVersion of its last write, and the array keeps the most recent
+     * one, so that readers can skip the whole array (or single components) when nothing changed.
+     *
+     * All the storage comes from the memory resource given at construction, which is also handed to
+     * allocator-aware components (declaring an `allocator_type`) for their own containers.
+     */
     template<typename T>
     class ComponentArray final : public IComponentArray {
-        std::vector<T> m_ComponentArray;
+        SparseSet m_Entities;
+        std::pmr::vector<T> m_ComponentArray;
+        std::pmr::vector<ChangeVersion> m_ChangeVersions;
+        ChangeVersion m_ChangeVersion = 0;
 
         ComponentTypeId m_TypeID;
-        std::unordered_map<EntityID, size_t> m_EntityToIndexMap;
-        std::unordered_map<size_t, EntityID> m_IndexToEntityMap;
-
-        size_t m_Size = 0;
 
         T m_Default{};
 
-        /** Inserts a component for the given entity.
+        /** Inserts a component for the given entity, or overwrites it if the entity already has one.
         * Internal use only.
         */
-        void InternalInsert(const EntityID entity, const T &component) {
-            m_EntityToIndexMap[entity] = m_Size;
-            m_IndexToEntityMap[m_Size] = entity;
-            m_ComponentArray.push_back(component);
-            m_Size++;
+        void InternalInsert(const EntityID entity, T component, const ChangeVersion version) {
+            if (const auto index = m_Entities.IndexOf(entity); index != SparseSet::INVALID_INDEX) {
+                m_ComponentArray[index] = std::move(component);
+                MarkChanged(index, version);
+                return;
+            }
+            m_Entities.Insert(entity);
+            m_ComponentArray.push_back(std::move(component));
+            m_ChangeVersions.push_back(version);
+            m_ChangeVersion = version;
         }
 
-        /** Swaps the component data between two entities.
-        * Used when an entity is removed and the last entity's data is moved to its place.
-        * Internal use only.
+        /** Position of the entity's component, which must exist.
         */
-        void InternalSwapEntityDataSwapEntityData(const EntityID entityA, const EntityID entityB) {
-            const auto entityAIndex = m_EntityToIndexMap[entityA],
-                    entityBIndex = m_EntityToIndexMap[entityB];
-
-            std::swap(
-                m_ComponentArray[entityAIndex],
-                m_ComponentArray[entityBIndex]
-            );
-
-            m_EntityToIndexMap[entityA] = entityBIndex;
-            m_EntityToIndexMap[entityB] = entityAIndex;
-            m_IndexToEntityMap[entityAIndex] = entityB;
-            m_IndexToEntityMap[entityBIndex] = entityA;
+        [[nodiscard]] uint32_t GetExistingIndex(const EntityID entity) const {
+            const auto index = m_Entities.IndexOf(entity);
+            if (index == SparseSet::INVALID_INDEX) {
+                throw std::runtime_error("Retrieving non-existent component.");
+            }
+            return index;
         }
 
     public:
-        ComponentArray() {
+        explicit ComponentArray(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : m_Entities(resource), m_ComponentArray(resource), m_ChangeVersions(resource) {
             m_TypeID = ComponentTypeHelper<T>::ID;
         }
 
@@ -76,26 +109,118 @@ namespace Entities {
         /** Checks if the given entity has a component stored in this array.
         */
         [[nodiscard]] bool HasData(const EntityID entity) const override {
-            return m_EntityToIndexMap.contains(entity);
+            return m_Entities.Contains(entity);
         }
 
         /** Inserts a component for the given entity.
         */
-        void InsertData(const EntityID entity, const T &component) {
-            InternalInsert(entity, component);
+        void InsertData(const EntityID entity, T component, const ChangeVersion version) {
+            InternalInsert(entity, std::move(component), version);
         }
 
         /** Inserts a default-initialized component for the given entity.
         */
-        void InsertDefault(const EntityID entity) override {
+        void InsertDefault(const EntityID entity, const ChangeVersion version) override {
             const auto defaultCopy = m_Default;
-            InternalInsert(entity, defaultCopy);
+            InternalInsert(entity, defaultCopy, version);
+        }
+
+        void InsertMoved(const EntityID entity, void *component, const ChangeVersion version) override {
+            InternalInsert(entity, std::move(*static_cast<T *>(component)), version);
+        }
+
+        void InsertCopies(
+            const std::vector<EntityID> &entities,
+            const void *component,
+            const ChangeVersion version
+        ) override {
+            for (const auto entity: entities) {
+                m_Entities.Insert(entity);
+            }
+            m_ComponentArray.insert(m_ComponentArray.end(), entities.size(), *static_cast<const T *>(component));
+            m_ChangeVersions.insert(m_ChangeVersions.end(), entities.size(), version);
+            m_ChangeVersion = version;
+        }
+
+        [[nodiscard]] const void *GetDataPointer(const EntityID entity) const override {
+            const auto index = m_Entities.IndexOf(entity);
+            return index == SparseSet::INVALID_INDEX ? nullptr : &m_ComponentArray[index];
+        }
+
+        void Capture(ComponentSnapshot &snapshot) const override {
+            snapshot.entities.assign(m_Entities.begin(), m_Entities.end());
+            snapshot.versions.assign(m_ChangeVersions.begin(), m_ChangeVersions.end());
+            snapshot.components.reset();
+            if (!m_ComponentArray.empty()) {
+                snapshot.components = std::make_unique<ComponentColumn>(ComponentInfo::Of<T>());
+                snapshot.components->PushRange(m_ComponentArray.data(), m_ComponentArray.size());
+            }
+        }
+
+        void Restore(const ComponentSnapshot &snapshot, const ChangeVersion version) override {
+            m_Entities.Clear();
+            m_Entities.Reserve(snapshot.entities.size());
+            for (const auto entity: snapshot.entities) {
+                m_Entities.Insert(entity);
+            }
+
+            m_ComponentArray.clear();
+            if (snapshot.components) {
+                const auto components = static_cast<const T *>(snapshot.components->Get(0));
+                m_ComponentArray.assign(components, components + snapshot.components->Size());
+            }
+            m_ChangeVersions.assign(m_ComponentArray.size(), version);
+            m_ChangeVersion = version;
         }
 
-        /** Retrieves a reference to the component data for the given entity.
+        /** Retrieves a reference to the component data for the given entity, which is marked as changed
+        * at `version`.
+        *
+        * @throws std::runtime_error if the entity has no component stored in this array.
         */
-        T &GetData(const EntityID entity) {
-            return m_ComponentArray[m_EntityToIndexMap[entity]];
+        T &GetData(const EntityID entity, const ChangeVersion version) {
+            const auto index = GetExistingIndex(entity);
+            MarkChanged(index, version);
+            return m_ComponentArray[index];
+        }
+
+        /** Retrieves the component data for the given entity, without marking it as changed.
+        *
+        * @throws std::runtime_error if the entity has no component stored in this array.
+        */
+        [[nodiscard]] const T &GetData(const EntityID entity) const {
+            return m_ComponentArray[GetExistingIndex(entity)];
+        }
+
+        /** Returns the position of the entity's component in storage, or SparseSet::INVALID_INDEX.
+        */
+        [[nodiscard]] uint32_t IndexOf(const EntityID entity) const {
+            return m_Entities.IndexOf(entity);
+        }
+
+        /** Retrieves the component stored at the given position (see IndexOf).
+        */
+        T &GetAt(const uint32_t index) {
+            return m_ComponentArray[index];
+        }
+
+        /** Records a write to the component stored at the given position.
+        */
+        void MarkChanged(const uint32_t index, const ChangeVersion version) {
+            m_ChangeVersions[index] = version;
+            m_ChangeVersion = version;
+        }
+
+        /** Version of the last write to the component stored at the given position.
+        */
+        [[nodiscard]] ChangeVersion GetChangeVersionAt(const uint32_t index) const {
+            return m_ChangeVersions[index];
+        }
+
+        /** Version of the last write to any component of this array.
+        */
+        [[nodiscard]] ChangeVersion GetChangeVersion() const {
+            return m_ChangeVersion;
         }
 
         /** Removes the component data for the given entity.
@@ -105,19 +230,37 @@ namespace Entities {
                 throw std::runtime_error("Trying to remove NULL_ENTITY from ComponentArray");
             }
 
-            if (!m_EntityToIndexMap.contains(entity)) {
+            if (!m_Entities.Contains(entity)) {
                 return;
             }
 
-            const size_t indexOfLastElement = m_Size - 1;
-            const EntityID entityOfLastElement = m_IndexToEntityMap[indexOfLastElement];
-
-            InternalSwapEntityDataSwapEntityData(entity, entityOfLastElement);
-            m_EntityToIndexMap.erase(entity);
-            m_IndexToEntityMap.erase(indexOfLastElement);
+            // Mirror the swap-and-pop performed by the sparse set on the component data.
+            if (const auto index = m_Entities.Remove(entity); index != m_ComponentArray.size() - 1) {
+                m_ComponentArray[index] = std::move(m_ComponentArray.back());
+                m_ChangeVersions[index] = m_ChangeVersions.back();
+            }
             m_ComponentArray.pop_back();
+            m_ChangeVersions.pop_back();
+        }
 
-            m_Size--;
+        /** Reserves room for `capacity` components in total.
+        */
+        void Reserve(const size_t capacity) {
+            m_Entities.Reserve(capacity);
+            m_ComponentArray.reserve(capacity);
+            m_ChangeVersions.reserve(capacity);
+        }
+
+        /** Returns the number of components stored in this array.
+        */
+        [[nodiscard]] size_t Size() const {
+            return m_ComponentArray.size();
+        }
+
+        /** Returns the entities owning the stored components, in storage order.
+        */
+        [[nodiscard]] const std::pmr::vector<EntityID> &GetEntities() const {
+            return m_Entities.GetDense();
         }
     };
 }
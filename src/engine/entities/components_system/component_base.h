@@ -1,22 +1,80 @@
 #ifndef GAME_ENGINE_ENTITY_COMPONENT_BASE_H
 #define GAME_ENGINE_ENTITY_COMPONENT_BASE_H
+#include <cstddef>
 #include <cstdint>
+#include <type_traits>
 
 using ComponentTypeId = uint8_t;
 
-inline ComponentTypeId GetNewComponentTypeID() {
-    static ComponentTypeId lastID = 0;
-    return lastID++;
-}
+struct InternalTagComponent;
+struct PhysicsSettingsComponent;
+struct ParentComponent;
+/** Placeholder keeping the type ID of the removed ChildrenComponent (replaced by FlatHierarchy) reserved.
+ *  Never defined, registered or stored.
+ */
+struct RetiredChildrenComponent;
+struct CameraComponent;
+struct LocalToWorldComponent;
+struct LocalTransformComponent;
+struct VelocityComponent;
+struct RenderableComponent;
+struct PlayerControllerComponent;
+struct ActiveCameraTagComponent;
+struct EditorCameraTagComponent;
+
+template<typename... Ts>
+struct ComponentTypeList {
+    static constexpr size_t Size = sizeof...(Ts);
+
+    /** Position of T in the list, or Size if T is not part of it.
+     */
+    template<typename T>
+    static constexpr size_t IndexOf() {
+        constexpr bool matches[] = {std::is_same_v<T, Ts>..., false};
+        size_t index = 0;
+        while (index < Size && !matches[index]) {
+            ++index;
+        }
+        return index;
+    }
+};
+
+/** Every component type (Components + Tags), in type ID order.
+ *
+ * Type IDs are positions in this list: they are known at compile time and identical across builds, so
+ * signatures can be stored as raw bits. Append new component types at the end to keep existing IDs stable, and
+ * replace removed ones with a never-defined placeholder type (e.g. RetiredChildrenComponent).
+ */
+using ComponentTypes = ComponentTypeList<
+    InternalTagComponent,
+    PhysicsSettingsComponent,
+    ParentComponent,
+    RetiredChildrenComponent,
+    CameraComponent,
+    LocalToWorldComponent,
+    LocalTransformComponent,
+    VelocityComponent,
+    RenderableComponent,
+    PlayerControllerComponent,
+    ActiveCameraTagComponent,
+    EditorCameraTagComponent
+>;
+
+static_assert(ComponentTypes::Size <= 256, "ComponentTypeId cannot address every component type");
 
 template<typename T>
 class ComponentTypeHelper {
+    static constexpr size_t INDEX = ComponentTypes::IndexOf<std::remove_cv_t<T> >();
+    static_assert(INDEX < ComponentTypes::Size, "Component type missing from ComponentTypes");
+
 public:
-    static const ComponentTypeId ID;
+    static constexpr ComponentTypeId ID = static_cast<ComponentTypeId>(INDEX);
 };
 
+/** Components without data (tags) only exist as a bit of the entity signature: no storage is allocated for them.
+ */
 template<typename T>
-const ComponentTypeId ComponentTypeHelper<T>::ID = GetNewComponentTypeID();
+inline constexpr bool IS_TAG_COMPONENT = std::is_empty_v<T>;
 
 
 #endif //GAME_ENGINE_ENTITY_COMPONENT_BASE_H
@@ -0,0 +1,119 @@
+#ifndef VEE_COMPONENT_COLUMN_H
+#define VEE_COMPONENT_COLUMN_H
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+#include "archetype_storage.h"
+
+namespace Entities {
+    /** Type-erased growable array of the values of one component type, described by a ComponentInfo.
+     *
+     * Used to keep component copies outside of the live storage (prefabs, world snapshots).
+     */
+    class ComponentColumn {
+        struct Deleter {
+            void operator()(std::byte *ptr) const {
+                ::operator delete[](ptr, std::align_val_t{ARCHETYPE_COLUMN_ALIGNMENT});
+            }
+        };
+
+        ComponentInfo m_Info;
+        std::unique_ptr<std::byte[], Deleter> m_Data;
+        size_t m_Count = 0;
+        size_t m_Capacity = 0;
+
+    public:
+        explicit ComponentColumn(const ComponentInfo &info) : m_Info(info) {
+        }
+
+        ComponentColumn(const ComponentColumn &) = delete;
+
+        ComponentColumn &operator=(const ComponentColumn &) = delete;
+
+        ~ComponentColumn() {
+            for (size_t row = 0; row < m_Count; ++row) {
+                m_Info.destroy(Get(row));
+            }
+        }
+
+        [[nodiscard]] const ComponentInfo &GetInfo() const {
+            return m_Info;
+        }
+
+        [[nodiscard]] size_t Size() const {
+            return m_Count;
+        }
+
+        [[nodiscard]] void *Get(const size_t row) const {
+            return m_Data.get() + row * m_Info.size;
+        }
+
+        void Reserve(const size_t capacity) {
+            if (capacity <= m_Capacity) {
+                return;
+            }
+            std::unique_ptr<std::byte[], Deleter> data(static_cast<std::byte *>(
+                ::operator new[](capacity * m_Info.size, std::align_val_t{ARCHETYPE_COLUMN_ALIGNMENT})
+            ));
+            for (size_t row = 0; row < m_Count; ++row) {
+                m_Info.moveConstruct(data.get() + row * m_Info.size, Get(row), std::pmr::get_default_resource());
+                m_Info.destroy(Get(row));
+            }
+            m_Data = std::move(data);
+            m_Capacity = capacity;
+        }
+
+        uint32_t Push(const void *component) {
+            if (m_Count == m_Capacity) {
+                Reserve(std::max<size_t>(4, m_Capacity * 2));
+            }
+            m_Info.CopyConstruct(Get(m_Count), component, std::pmr::get_default_resource());
+            return static_cast<uint32_t>(m_Count++);
+        }
+
+        /** Appends copies of `count` contiguous components starting at `components`.
+         */
+        void PushRange(const void *components, const size_t count) {
+            if (m_Count + count > m_Capacity) {
+                Reserve(std::max(m_Count + count, m_Capacity * 2));
+            }
+            m_Info.CopyConstructRange(Get(m_Count), components, count, std::pmr::get_default_resource());
+            m_Count += count;
+        }
+
+        void Replace(const uint32_t row, const void *component) const {
+            m_Info.destroy(Get(row));
+            m_Info.CopyConstruct(Get(row), component, std::pmr::get_default_resource());
+        }
+    };
+
+    /** Copy of the components of one type, with their owners and the ChangeVersion of their last write
+     * (see WorldSnapshot). Rows of the three arrays match.
+     */
+    struct ComponentSnapshot {
+        std::vector<EntityID> entities;
+        std::vector<ChangeVersion> versions;
+        /** Null when no entity owns the component.
+         */
+        std::unique_ptr<ComponentColumn> components;
+
+        /** Makes room for `count` more rows of the given type.
+         */
+        void Reserve(const ComponentInfo &info, const size_t count) {
+            if (!components) {
+                components = std::make_unique<ComponentColumn>(info);
+            }
+            components->Reserve(components->Size() + count);
+            entities.reserve(entities.size() + count);
+            versions.reserve(versions.size() + count);
+        }
+    };
+}
+
+#endif //VEE_COMPONENT_COLUMN_H
@@ -2,66 +2,247 @@
 #define GAME_ENGINE_COMPONENT_MANAGER_H
 #include <unordered_map>
 
+#include "archetype_storage.h"
 #include "component_array.h"
+#include "../command_buffer.h"
+#include "../flat_hierarchy.h"
 #include "../manager.h"
+#include "../prefab.h"
+#include "../world_snapshot.h"
 #include "../system/system_manager.h"
+#include "../components_system/components/parent_component.h"
 #include "../components_system/tags/internal_tag_component.h"
 
 class EntityManager;
 
+namespace Utils::Entities::Iteration {
+    template<typename... Ts>
+    class View;
+}
+
+/** Selects how a ComponentManager lays out component data in memory.
+ */
+enum class ComponentStorageMode {
+    /** One packed ComponentArray per component type.
+     */
+    PerType,
+    /** Entities sharing a signature are stored together in fixed-size SoA chunks (see ArchetypeStorage).
+     */
+    Archetype,
+};
+
 class ComponentManager {
+    /** Arena of the entity manager, which all component storage is allocated from.
+     *  Declared first: it must outlive the storage.
+     */
+    std::shared_ptr<Utils::MemoryArena> m_MemoryArena;
     std::shared_ptr<EntityManager> m_EntityManager;
     std::shared_ptr<SystemManager> m_SystemManager;
     std::vector<ComponentTypeId> m_RegisteredComponentTypes;
     std::array<std::shared_ptr<IComponentArray>, MAX_COMPONENTS> m_ComponentArrays;
     std::unordered_map<ComponentTypeId, std::string> m_ComponentNameMap;
+    /** Type-erased descriptions of the registered (non-tag) component types, for copies made without the type.
+     */
+    std::array<ComponentInfo, MAX_COMPONENTS> m_ComponentInfos{};
+    /** Registered tag components, which are stored in entity signatures only.
+     */
+    Signature m_TagSignature;
+
+    ComponentStorageMode m_StorageMode;
+    /** Version stamped on every component written through this manager.
+     */
+    ChangeVersion m_ChangeVersion = 1;
+    ArchetypeStorage m_ArchetypeStorage;
+    /** Parent/child links, mirrored in the ParentComponent of the entities.
+     */
+    FlatHierarchy m_Hierarchy;
+
+    EntityCommandBuffer m_CommandBuffer;
+
+    // Signature batching: while active, system notifications are deferred to EndSignatureBatch and
+    // coalesced into one per entity.
+    bool m_BatchingSignatures = false;
+    std::vector<std::pair<EntityID, Signature> > m_BatchedSignatures;
+    SparseSet m_BatchedEntities;
 
+    template<typename... Ts>
+    friend class Utils::Entities::Iteration::View;
+
+    /** Returns the typed array for T without touching the shared_ptr reference count.
+     */
     template<typename T>
-    std::shared_ptr<ComponentArray<T> > GetComponentArray() {
+    ComponentArray<T> *GetComponentArray() const {
         const ComponentTypeId typeID = ComponentTypeHelper<T>::ID;
-        return std::static_pointer_cast<ComponentArray<T> >(m_ComponentArrays[typeID]);
+        return static_cast<ComponentArray<T> *>(m_ComponentArrays[typeID].get());
+    }
+
+    /** Stores the new signature of the entity and notifies the systems (immediately or at the end of the batch).
+     */
+    void CommitSignature(const EntityID entity, const Signature &previousSignature, const Signature &signature) {
+        m_EntityManager->SetSignature(entity, signature);
+
+        if (!m_BatchingSignatures) {
+            m_SystemManager->EntitySignatureChanged(entity, previousSignature, signature);
+            return;
+        }
+        if (!m_BatchedEntities.Contains(entity)) {
+            m_BatchedEntities.Insert(entity);
+            m_BatchedSignatures.emplace_back(entity, previousSignature);
+        }
+    }
+
+    void CheckRegistered(const Signature &signature) const {
+        for (size_t typeId = 0; typeId < COMPONENTS_COUNT; ++typeId) {
+            if (signature.test(typeId) && !m_ComponentNameMap.contains(static_cast<ComponentTypeId>(typeId))) {
+                throw std::runtime_error("Component type not registered: " + std::to_string(typeId));
+            }
+        }
+    }
+
+    /** Registers freshly created entities with the systems (or with the current signature batch).
+     */
+    void CommitCreatedEntities(const std::vector<EntityID> &entities, const Signature &signature) {
+        if (m_BatchingSignatures) {
+            for (const auto entity: entities) {
+                m_BatchedEntities.Insert(entity);
+                m_BatchedSignatures.emplace_back(entity, Signature{});
+            }
+        } else {
+            m_SystemManager->EntitiesCreated(entities, signature);
+        }
+    }
+
+    /** Returns the address of the component of the given type owned by the entity, or nullptr.
+     */
+    [[nodiscard]] const void *GetComponentDataPointer(const ComponentTypeId typeId, const EntityID entity) const {
+        if (m_StorageMode == ComponentStorageMode::Archetype) {
+            return m_ArchetypeStorage.GetDataPointer(typeId, entity);
+        }
+        const auto &componentArray = m_ComponentArrays[typeId];
+        return componentArray ? componentArray->GetDataPointer(entity) : nullptr;
+    }
+
+    /** Adds (or replaces) a component of the given type by moving from `component`.
+     */
+    void AddMovedComponent(const ComponentTypeId typeId, const EntityID entity, void *component) {
+        if (!m_ComponentNameMap.contains(typeId)) {
+            throw std::runtime_error("Component type not registered: " + std::to_string(typeId));
+        }
+        const Signature previousSignature = m_EntityManager->GetSignature(entity);
+        if (typeId == ComponentTypeHelper<ParentComponent>::ID) {
+            m_Hierarchy.SetParent(entity, static_cast<const ParentComponent *>(component)->parent);
+        }
+
+        if (m_TagSignature.test(typeId)) {
+            // Nothing to store.
+        } else if (m_StorageMode == ComponentStorageMode::Archetype) {
+            m_ArchetypeStorage.InsertMoved(typeId, entity, component, m_ChangeVersion);
+        } else {
+            m_ComponentArrays[typeId]->InsertMoved(entity, component, m_ChangeVersion);
+        }
+
+        Signature signature = previousSignature;
+        signature.set(typeId);
+        CommitSignature(entity, previousSignature, signature);
     }
 
 public:
     ComponentManager(
         const std::shared_ptr<SystemManager> &systemManager,
-        const std::shared_ptr<EntityManager> &entityManager
-    ) : m_EntityManager(entityManager), m_SystemManager(systemManager) {
+        const std::shared_ptr<EntityManager> &entityManager,
+        const ComponentStorageMode storageMode = ComponentStorageMode::PerType
+    ) : m_MemoryArena(entityManager->GetMemoryArena()),
+        m_EntityManager(entityManager),
+        m_SystemManager(systemManager),
+        m_StorageMode(storageMode),
+        m_ArchetypeStorage(m_MemoryArena.get()),
+        m_Hierarchy(*entityManager, m_MemoryArena.get()) {
+    }
+
+    [[nodiscard]] ComponentStorageMode GetStorageMode() const {
+        return m_StorageMode;
+    }
+
+    /** Version currently stamped on written components.
+     */
+    [[nodiscard]] ChangeVersion GetChangeVersion() const {
+        return m_ChangeVersion;
+    }
+
+    /** Starts a new change version, typically once per frame before the systems are updated.
+     *
+     *  @return The new version.
+     */
+    ChangeVersion AdvanceChangeVersion() {
+        if (++m_ChangeVersion == 0) {
+            // 0 is reserved for "never": it compares as older than every stamp.
+            ++m_ChangeVersion;
+        }
+        return m_ChangeVersion;
     }
 
     template<typename T>
     void RegisterComponent(const std::string &componentName) {
         ComponentTypeId typeID = ComponentTypeHelper<T>::ID;
-        m_ComponentArrays[typeID] = std::make_shared<ComponentArray<T> >();
+        if constexpr (IS_TAG_COMPONENT<T>) {
+            m_TagSignature.set(typeID);
+        } else {
+            m_ComponentInfos[typeID] = ComponentInfo::Of<T>();
+            if (m_StorageMode == ComponentStorageMode::Archetype) {
+                m_ArchetypeStorage.RegisterComponent(m_ComponentInfos[typeID]);
+            } else {
+                m_ComponentArrays[typeID] = std::make_shared<ComponentArray<T> >(m_MemoryArena.get());
+            }
+        }
         m_ComponentNameMap.insert({typeID, componentName});
         m_RegisteredComponentTypes.push_back(typeID);
     }
 
     template<typename T>
     T AddComponent(EntityID entity, T component) {
-        GetComponentArray<T>()->InsertData(entity, component);
-
-        Signature signature = m_EntityManager->GetSignature(entity);
+        // Fetched first: throws for destroyed entities before any storage is touched.
+        const Signature previousSignature = m_EntityManager->GetSignature(entity);
+        Signature signature = previousSignature;
         const ComponentTypeId typeID = ComponentTypeHelper<T>::ID;
+        if constexpr (std::is_same_v<T, ParentComponent>) {
+            m_Hierarchy.SetParent(entity, component.parent);
+        }
+
+        if constexpr (IS_TAG_COMPONENT<T>) {
+            // Nothing to store.
+        } else if (m_StorageMode == ComponentStorageMode::Archetype) {
+            m_ArchetypeStorage.Insert<T>(entity, component, m_ChangeVersion);
+        } else {
+            GetComponentArray<T>()->InsertData(entity, component, m_ChangeVersion);
+        }
 
         signature.set(typeID);
 
-        m_EntityManager->SetSignature(entity, signature);
-        m_SystemManager->EntitySignatureChanged(entity, signature);
+        CommitSignature(entity, previousSignature, signature);
 
         return component;
     }
 
-    void AddDefaultComponent(const ComponentTypeId typeId, const EntityID entity) const {
-        if (m_ComponentArrays[typeId]) {
-            m_ComponentArrays[typeId]->InsertDefault(entity);
-
-            Signature signature = m_EntityManager->GetSignature(entity);
+    void AddDefaultComponent(const ComponentTypeId typeId, const EntityID entity) {
+        if (m_ComponentNameMap.contains(typeId)) {
+            const Signature previousSignature = m_EntityManager->GetSignature(entity);
+            Signature signature = previousSignature;
             const ComponentTypeId typeID = typeId;
+            if (typeId == ComponentTypeHelper<ParentComponent>::ID) {
+                m_Hierarchy.SetParent(entity, NULL_ENTITY);
+            }
+
+            if (m_TagSignature.test(typeId)) {
+                // Nothing to store.
+            } else if (m_StorageMode == ComponentStorageMode::Archetype) {
+                m_ArchetypeStorage.InsertDefault(typeId, entity, m_ChangeVersion);
+            } else {
+                m_ComponentArrays[typeId]->InsertDefault(entity, m_ChangeVersion);
+            }
+
             signature.set(typeID);
 
-            m_EntityManager->SetSignature(entity, signature);
-            m_SystemManager->EntitySignatureChanged(entity, signature);
+            CommitSignature(entity, previousSignature, signature);
         } else {
             throw std::runtime_error("Component type not registered: " + std::to_string(typeId));
         }
@@ -69,21 +250,81 @@ public:
 
     template<typename T>
     T &GetComponent(EntityID entity) {
-        return GetComponentArray<T>()->GetData(entity);
+        if constexpr (IS_TAG_COMPONENT<T>) {
+            if (!HasComponent<T>(entity)) {
+                throw std::runtime_error("Retrieving non-existent component.");
+            }
+            // Tags have no state, any instance will do.
+            static T tag;
+            return tag;
+        } else {
+            if (m_StorageMode == ComponentStorageMode::Archetype) {
+                return m_ArchetypeStorage.Get<T>(entity, m_ChangeVersion);
+            }
+            return GetComponentArray<T>()->GetData(entity, m_ChangeVersion);
+        }
+    }
+
+    /** Returns the component of the entity without marking it as changed.
+     *
+     *  Prefer it over GetComponent when the component is only read, so that change filters
+     *  (see View::ChangedSince) are not triggered.
+     */
+    template<typename T>
+    [[nodiscard]] const T &GetComponentReadOnly(const EntityID entity) const {
+        if constexpr (IS_TAG_COMPONENT<T>) {
+            if (!HasComponent<T>(entity)) {
+                throw std::runtime_error("Retrieving non-existent component.");
+            }
+            static const T tag;
+            return tag;
+        } else {
+            if (m_StorageMode == ComponentStorageMode::Archetype) {
+                return m_ArchetypeStorage.Get<T>(entity);
+            }
+            return GetComponentArray<T>()->GetData(entity);
+        }
     }
 
-    void RemoveEntity(const EntityID entity) const {
+    void RemoveEntity(const EntityID entity) {
+        // Children outlive their parent, as roots.
+        m_Hierarchy.ForEachChild(entity, [this](const EntityID child) {
+            if (HasComponent<ParentComponent>(child)) {
+                GetComponent<ParentComponent>(child).parent = NULL_ENTITY;
+            }
+        });
+        m_Hierarchy.RemoveEntity(entity);
+
+        if (m_StorageMode == ComponentStorageMode::Archetype) {
+            m_ArchetypeStorage.RemoveEntity(entity, m_ChangeVersion);
+            return;
+        }
         for (auto const &arr: m_ComponentArrays) {
-            arr->RemoveEntity(entity);
+            if (arr) {
+                arr->RemoveEntity(entity);
+            }
         }
     }
 
     [[nodiscard]] std::vector<ComponentTypeId> GetEntityComponents(const EntityID entity) const {
         std::vector<ComponentTypeId> components;
-        for (auto const &arr: m_ComponentArrays) {
-            if (arr && arr->HasData(entity)) {
-                const ComponentTypeId typeID = arr->GetTypeId();
-                components.push_back(typeID);
+        if (m_StorageMode == ComponentStorageMode::Archetype) {
+            components = m_ArchetypeStorage.GetComponentTypes(entity);
+        } else {
+            for (auto const &arr: m_ComponentArrays) {
+                if (arr && arr->HasData(entity)) {
+                    const ComponentTypeId typeID = arr->GetTypeId();
+                    components.push_back(typeID);
+                }
+            }
+        }
+
+        if (m_TagSignature.any() && m_EntityManager->IsAlive(entity)) {
+            const Signature tags = m_EntityManager->GetSignatureUnchecked(entity) & m_TagSignature;
+            for (size_t typeId = 0; typeId < COMPONENTS_COUNT; ++typeId) {
+                if (tags.test(typeId)) {
+                    components.push_back(static_cast<ComponentTypeId>(typeId));
+                }
             }
         }
         return components;
@@ -91,26 +332,50 @@ public:
 
     template<typename T>
     void RemoveComponent(const EntityID entity) {
-        GetComponentArray<T>()->RemoveEntity(entity);
+        RemoveComponent(ComponentTypeHelper<T>::ID, entity);
+    }
 
-        Signature signature = m_EntityManager->GetSignature(entity);
-        const ComponentTypeId typeID = ComponentTypeHelper<T>::ID;
+    void RemoveComponent(const ComponentTypeId typeId, const EntityID entity) {
+        const Signature previousSignature = m_EntityManager->GetSignature(entity);
+        Signature signature = previousSignature;
+        if (typeId == ComponentTypeHelper<ParentComponent>::ID) {
+            m_Hierarchy.SetParent(entity, NULL_ENTITY);
+        }
 
-        signature.set(typeID, false);
+        if (m_TagSignature.test(typeId)) {
+            // Nothing to remove from storage.
+        } else if (m_StorageMode == ComponentStorageMode::Archetype) {
+            m_ArchetypeStorage.Remove(typeId, entity, m_ChangeVersion);
+        } else if (m_ComponentArrays[typeId]) {
+            m_ComponentArrays[typeId]->RemoveEntity(entity);
+        }
 
-        m_EntityManager->SetSignature(entity, signature);
-        m_SystemManager->EntitySignatureChanged(entity, signature);
+        signature.set(typeId, false);
+
+        CommitSignature(entity, previousSignature, signature);
     }
 
     template<typename T>
     [[nodiscard]] bool HasComponent(const EntityID entity) const {
         const ComponentTypeId typeID = ComponentTypeHelper<T>::ID;
-        const auto componentArray = std::static_pointer_cast<ComponentArray<T> >(m_ComponentArrays[typeID]);
-        return componentArray->HasData(entity);
+        if constexpr (IS_TAG_COMPONENT<T>) {
+            return m_EntityManager->IsAlive(entity) && m_EntityManager->GetSignatureUnchecked(entity).test(typeID);
+        } else {
+            if (m_StorageMode == ComponentStorageMode::Archetype) {
+                return m_ArchetypeStorage.Has(typeID, entity);
+            }
+            return GetComponentArray<T>()->HasData(entity);
+        }
     }
 
     [[nodiscard]] bool HasComponent(const ComponentTypeId typeId, const EntityID entity) const {
-        const auto componentArray = m_ComponentArrays[typeId];
+        if (m_TagSignature.test(typeId)) {
+            return m_EntityManager->IsAlive(entity) && m_EntityManager->GetSignatureUnchecked(entity).test(typeId);
+        }
+        if (m_StorageMode == ComponentStorageMode::Archetype) {
+            return m_ArchetypeStorage.Has(typeId, entity);
+        }
+        const auto &componentArray = m_ComponentArrays[typeId];
         if (!componentArray) {
             return false;
         }
@@ -124,6 +389,363 @@ public:
     std::vector<ComponentTypeId> GetRegisteredComponents() {
         return m_RegisteredComponentTypes;
     }
+
+    /** Moves the entity, with its subtree, under a new parent, or makes it a root when `parent` is NULL_ENTITY.
+     *
+     *  The ParentComponent of the entity is added or updated accordingly. Adding, removing or replacing a
+     *  ParentComponent through the other methods of the manager also updates the hierarchy, but writing
+     *  `ParentComponent::parent` in place does not.
+     *
+     *  @throws std::runtime_error if an entity is not alive or if the new parent is a descendant of the entity.
+     */
+    void SetParent(const EntityID child, const EntityID parent) {
+        if (HasComponent<ParentComponent>(child)) {
+            m_Hierarchy.SetParent(child, parent);
+            GetComponent<ParentComponent>(child).parent = parent;
+        } else {
+            AddComponent(child, ParentComponent{parent});
+        }
+    }
+
+    /** Returns the hierarchy of the world, with its flattened order up to date.
+     *
+     *  Like other structural changes, reparenting must not happen while the returned order is being walked.
+     */
+    [[nodiscard]] const FlatHierarchy &GetHierarchy() {
+        m_Hierarchy.Refresh();
+        return m_Hierarchy;
+    }
+
+    /** Creates `count` entities owning the components `Ts`.
+     *
+     *  Storage is reserved once, the components are default-constructed and then handed to
+     *  `initializer(size_t index, EntityID entity, Ts &...components)`, and the whole range is registered
+     *  with the interested systems in a single pass.
+     *
+     *  @return The handles of the new entities, in creation order.
+     */
+    template<typename... Ts, typename Initializer>
+    std::vector<EntityID> CreateEntities(const size_t count, const std::string &name, Initializer &&initializer) {
+        Signature signature;
+        (signature.set(ComponentTypeHelper<Ts>::ID), ...);
+        CheckRegistered(signature);
+
+        const auto entities = m_EntityManager->CreateEntities(count, name, signature);
+
+        if (m_StorageMode == ComponentStorageMode::Archetype) {
+            m_ArchetypeStorage.InsertDefaultEntities(entities, signature & ~m_TagSignature, m_ChangeVersion);
+            for (size_t i = 0; i < count; ++i) {
+                initializer(i, entities[i], GetComponent<Ts>(entities[i])...);
+            }
+        } else {
+            const auto reserve = [this, count]<typename T>() {
+                if constexpr (!IS_TAG_COMPONENT<T>) {
+                    GetComponentArray<T>()->Reserve(GetComponentArray<T>()->Size() + count);
+                }
+            };
+            const auto insert = [this]<typename T>(const EntityID entity, T &component) {
+                if constexpr (!IS_TAG_COMPONENT<T>) {
+                    GetComponentArray<T>()->InsertData(entity, std::move(component), m_ChangeVersion);
+                }
+            };
+
+            (reserve.template operator()<Ts>(), ...);
+            for (size_t i = 0; i < count; ++i) {
+                std::tuple<Ts...> components{};
+                std::apply([&](Ts &... component) {
+                    initializer(i, entities[i], component...);
+                    (insert(entities[i], component), ...);
+                }, components);
+            }
+        }
+
+        CommitCreatedEntities(entities, signature);
+
+        return entities;
+    }
+
+    /** Captures an entity and all its descendants into a prefab.
+     *
+     *  Component values are copied; hierarchy links become prefab links, and InternalTagComponent
+     *  is left out so that instances are regular entities.
+     */
+    [[nodiscard]] Prefab CreatePrefab(const EntityID root) {
+        if (!m_EntityManager->IsAlive(root)) {
+            throw std::runtime_error("Cannot create a prefab from a destroyed entity");
+        }
+
+        // The subtree is a contiguous range of the flattened order, parents first: prefab indices are offsets in it.
+        const auto &hierarchy = GetHierarchy();
+        const uint32_t rootPosition = hierarchy.GetPosition(root);
+        const uint32_t size = hierarchy.GetSubtreeSizes()[rootPosition];
+
+        Prefab prefab;
+        for (uint32_t position = rootPosition; position < rootPosition + size; ++position) {
+            const EntityID entity = hierarchy.GetEntities()[position];
+            const uint32_t parent = position == rootPosition
+                                        ? Prefab::NO_PARENT
+                                        : hierarchy.GetParentPositions()[position] - rootPosition;
+
+            const uint32_t index = prefab.AddEntity(std::string(m_EntityManager->GetEntityName(entity)), parent);
+            for (const auto typeId: GetEntityComponents(entity)) {
+                if (typeId == ComponentTypeHelper<ParentComponent>::ID ||
+                    typeId == ComponentTypeHelper<InternalTagComponent>::ID) {
+                    continue;
+                }
+                if (m_TagSignature.test(typeId)) {
+                    prefab.AddTag(index, typeId);
+                } else {
+                    prefab.AddComponentCopy(index, m_ComponentInfos[typeId], GetComponentDataPointer(typeId, entity));
+                }
+            }
+        }
+        return prefab;
+    }
+
+    /** Creates `count` copies of the prefab.
+     *
+     *  Each prefab entity is created `count` times in one go and its component values are copied in bulk
+     *  (memcpy for trivially copyable components); hierarchy links are then remapped to the new entities.
+     *
+     *  @return The new entities, instance by instance: entity `i` of instance `c` is at `c * prefab.Size() + i`.
+     */
+    std::vector<EntityID> InstantiatePrefab(const Prefab &prefab, const size_t count) {
+        const auto &prefabEntities = prefab.GetEntities();
+        for (const auto &prefabEntity: prefabEntities) {
+            CheckRegistered(prefabEntity.signature);
+        }
+
+        std::vector<std::vector<EntityID> > created(prefabEntities.size());
+        for (uint32_t index = 0; index < prefabEntities.size(); ++index) {
+            const auto &prefabEntity = prefabEntities[index];
+            created[index] = m_EntityManager->CreateEntities(count, prefabEntity.name, prefabEntity.signature);
+
+            const Signature stored = prefabEntity.signature & ~m_TagSignature;
+            if (m_StorageMode == ComponentStorageMode::Archetype) {
+                std::array<const void *, COMPONENTS_COUNT> components{};
+                for (size_t typeId = 0; typeId < COMPONENTS_COUNT; ++typeId) {
+                    if (stored.test(typeId)) {
+                        components[typeId] = prefab.GetComponent(index, static_cast<ComponentTypeId>(typeId));
+                    }
+                }
+                m_ArchetypeStorage.InsertCopiedEntities(created[index], stored, components, m_ChangeVersion);
+            } else {
+                for (size_t typeId = 0; typeId < COMPONENTS_COUNT; ++typeId) {
+                    if (stored.test(typeId)) {
+                        m_ComponentArrays[typeId]->InsertCopies(
+                            created[index],
+                            prefab.GetComponent(index, static_cast<ComponentTypeId>(typeId)),
+                            m_ChangeVersion
+                        );
+                    }
+                }
+            }
+        }
+
+        for (uint32_t index = 0; index < prefabEntities.size(); ++index) {
+            const uint32_t parent = prefabEntities[index].parent;
+            if (parent == Prefab::NO_PARENT) {
+                continue;
+            }
+            for (size_t instance = 0; instance < count; ++instance) {
+                const EntityID child = created[index][instance];
+                const EntityID newParent = created[parent][instance];
+                m_Hierarchy.SetParent(child, newParent);
+                GetComponent<ParentComponent>(child).parent = newParent;
+            }
+        }
+
+        for (uint32_t index = 0; index < prefabEntities.size(); ++index) {
+            CommitCreatedEntities(created[index], prefabEntities[index].signature);
+        }
+
+        std::vector<EntityID> entities(count * prefabEntities.size());
+        for (size_t instance = 0; instance < count; ++instance) {
+            for (size_t index = 0; index < prefabEntities.size(); ++index) {
+                entities[instance * prefabEntities.size() + index] = created[index][instance];
+            }
+        }
+        return entities;
+    }
+
+    /** Copies the whole world (entity tables and every stored component) into a snapshot.
+     *
+     *  The change version is advanced afterwards, so that writes made after the capture can be told apart
+     *  (see WorldSnapshot::Diff).
+     */
+    [[nodiscard]] WorldSnapshot CaptureSnapshot() {
+        WorldSnapshot snapshot;
+        snapshot.m_Source = this;
+        snapshot.m_Entities = m_EntityManager->CaptureTables();
+        if (m_StorageMode == ComponentStorageMode::Archetype) {
+            m_ArchetypeStorage.Capture(snapshot.m_Components, snapshot.m_Archetypes);
+        } else {
+            for (size_t typeId = 0; typeId < COMPONENTS_COUNT; ++typeId) {
+                if (m_ComponentArrays[typeId]) {
+                    m_ComponentArrays[typeId]->Capture(snapshot.m_Components[typeId]);
+                }
+            }
+        }
+        snapshot.m_ChangeVersion = AdvanceChangeVersion();
+        return snapshot;
+    }
+
+    /** Puts the world back in the state of a snapshot taken by CaptureSnapshot on this manager.
+     *
+     *  Entities keep their handles; entities created since the capture are gone and their handles are stale.
+     *  Restored components are marked as changed, pending recorded commands are dropped, and the hierarchy
+     *  (from the restored ParentComponents) and system memberships are rebuilt.
+     */
+    void RestoreSnapshot(const WorldSnapshot &snapshot) {
+        if (snapshot.m_Source != this) {
+            throw std::runtime_error("World snapshot taken from another component manager");
+        }
+        if (m_BatchingSignatures) {
+            throw std::runtime_error("Cannot restore a world snapshot during a signature batch");
+        }
+
+        m_CommandBuffer.Clear();
+        const ChangeVersion version = AdvanceChangeVersion();
+        m_EntityManager->RestoreTables(snapshot.m_Entities);
+        if (m_StorageMode == ComponentStorageMode::Archetype) {
+            m_ArchetypeStorage.Restore(snapshot.m_Components, snapshot.m_Archetypes, version);
+        } else {
+            for (size_t typeId = 0; typeId < COMPONENTS_COUNT; ++typeId) {
+                if (m_ComponentArrays[typeId]) {
+                    m_ComponentArrays[typeId]->Restore(snapshot.m_Components[typeId], version);
+                }
+            }
+        }
+
+        m_Hierarchy.Clear();
+        m_SystemManager->ClearEntities();
+        std::unordered_map<Signature, std::vector<EntityID> > entitiesBySignature;
+        for (const auto entity: m_EntityManager->GetActiveEntities()) {
+            if (HasComponent<ParentComponent>(entity)) {
+                if (const EntityID parent = GetComponentReadOnly<ParentComponent>(entity).parent; parent != NULL_ENTITY) {
+                    m_Hierarchy.SetParent(entity, parent);
+                }
+            }
+            entitiesBySignature[m_EntityManager->GetSignatureUnchecked(entity)].push_back(entity);
+        }
+        for (const auto &[signature, entities]: entitiesBySignature) {
+            m_SystemManager->EntitiesCreated(entities, signature);
+        }
+    }
+
+    /** Defers system notifications until EndSignatureBatch.
+     *
+     *  Storage and entity signatures are still updated immediately; only the SystemManager dispatch is
+     *  delayed, and an entity changed several times in the batch is dispatched once.
+     */
+    void BeginSignatureBatch() {
+        m_BatchingSignatures = true;
+    }
+
+    /** Notifies the systems of every signature changed since BeginSignatureBatch.
+     */
+    void EndSignatureBatch() {
+        m_BatchingSignatures = false;
+
+        for (const auto &[entity, previousSignature]: m_BatchedSignatures) {
+            if (!m_EntityManager->IsAlive(entity)) {
+                continue;
+            }
+            if (const auto &signature = m_EntityManager->GetSignatureUnchecked(entity); signature != previousSignature) {
+                m_SystemManager->EntitySignatureChanged(entity, previousSignature, signature);
+            }
+        }
+
+        m_BatchedSignatures.clear();
+        m_BatchedEntities.Clear();
+    }
+
+    /** Shared command buffer for structural changes requested while systems run.
+     *  It is played back by the engine once all systems have been updated.
+     */
+    EntityCommandBuffer &GetCommandBuffer() {
+        return m_CommandBuffer;
+    }
+
+    void PlaybackCommands() {
+        PlaybackCommands(m_CommandBuffer);
+    }
+
+    /** Applies and clears the commands of the buffer, with a single system notification per changed entity.
+     *
+     *  Commands targeting entities that are no longer alive are skipped, as are destructions of internal entities.
+     */
+    void PlaybackCommands(EntityCommandBuffer &commandBuffer) {
+        using CommandType = EntityCommandBuffer::CommandType;
+
+        std::vector<EntityID> createdEntities(commandBuffer.GetPendingEntityCount(), NULL_ENTITY);
+        const auto resolve = [&createdEntities](const EntityID entity) {
+            return EntityCommandBuffer::IsPending(entity) ? createdEntities[GetEntityIndex(entity)] : entity;
+        };
+
+        BeginSignatureBatch();
+        try {
+            for (const auto &command: commandBuffer.GetCommands()) {
+                if (command.type == CommandType::CreateEntity) {
+                    const EntityID entity = m_EntityManager->CreateEntity(commandBuffer.GetEntityName(command));
+                    createdEntities[GetEntityIndex(command.entity)] = entity;
+                    continue;
+                }
+
+                const EntityID entity = resolve(command.entity);
+                if (!m_EntityManager->IsAlive(entity)) {
+                    continue;
+                }
+
+                switch (command.type) {
+                    case CommandType::DestroyEntity:
+                        if (!HasComponent<InternalTagComponent>(entity)) {
+                            m_EntityManager->RemoveEntity(entity);
+                            RemoveEntity(entity);
+                            m_SystemManager->RemoveEntity(entity);
+                        }
+                        break;
+                    case CommandType::AddComponent:
+                        AddMovedComponent(command.typeId, entity, command.component);
+                        break;
+                    case CommandType::RemoveComponent:
+                        RemoveComponent(command.typeId, entity);
+                        break;
+                    default:
+                        break;
+                }
+            }
+        } catch (...) {
+            EndSignatureBatch();
+            commandBuffer.Clear();
+            throw;
+        }
+        EndSignatureBatch();
+        commandBuffer.Clear();
+    }
+
+    /** Streams over every archetype chunk containing all the requested components.
+     *
+     * `func` is called as `func(size_t count, const EntityID *entities, Ts *...columns)` where each column
+     * is a contiguous array of `count` components. Only available in ComponentStorageMode::Archetype; in
+     * PerType mode no chunk exists and `func` is never called. Columns of non-const types are marked as changed.
+     */
+    template<typename... Ts, typename Func>
+    void ForEachChunk(Func &&func) {
+        Signature signature;
+        (signature.set(ComponentTypeHelper<Ts>::ID), ...);
+
+        m_ArchetypeStorage.ForEachChunk(signature, [&](const Archetype &archetype, ArchetypeChunk &chunk) {
+            ((std::is_const_v<Ts>
+                  ? void()
+                  : archetype.MarkChanged(chunk, ComponentTypeHelper<Ts>::ID, m_ChangeVersion)), ...);
+            func(
+                chunk.Count(),
+                static_cast<const EntityID *>(archetype.GetEntities(chunk)),
+                archetype.template GetColumn<Ts>(chunk)...
+            );
+        });
+    }
 };
 
 
@@ -6,9 +6,12 @@ struct LocalToWorldComponent final {
     /** Cached local to world transformation matrix.
      */
     glm::mat4 localToWorldMatrix{};
-    /** Flag indicating whether the local to world matrix needs to be recomputed.
-     *
-     * TODO: Currently always set to true. Implement proper dirty flag logic.
+    /** Local to world matrix of the previous simulation step, which rendering interpolates from (see
+     *  Engine::Update). Equal to localToWorldMatrix when the entity did not move during the last step.
+     */
+    glm::mat4 previousLocalToWorldMatrix{};
+    /** True until the TransformSystem has computed the matrix for the first time.
+     *  Later updates are driven by the change versions of LocalTransformComponent (see TransformSystem).
      */
     bool isDirty = true;
 };
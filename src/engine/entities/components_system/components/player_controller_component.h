@@ -1,5 +1,7 @@
 #ifndef VEE_PLAYER_CONTROLLER_COMPONENT_H
 #define VEE_PLAYER_CONTROLLER_COMPONENT_H
+#include <glm/glm.hpp>
+
 #include "../../../io/input_system.h"
 
 struct PlayerControllerComponent final {
@@ -0,0 +1,90 @@
+#ifndef VEE_ENTITY_QUERY_H
+#define VEE_ENTITY_QUERY_H
+#include <cstddef>
+
+#include "sparse_set.h"
+#include "types.h"
+
+class EntityManager;
+
+namespace Entities {
+    /** Counters describing the cost of the cached queries of an EntityManager.
+     */
+    struct EntityQueryStatistics {
+        /** Number of lookups answered by an already registered query.
+         */
+        size_t hits = 0;
+        /** Number of lookups that had to register (and populate) a new query.
+         */
+        size_t misses = 0;
+        /** Number of query signatures tested against an entity signature while maintaining the queries.
+         */
+        size_t signatureChecks = 0;
+        /** Number of entities inserted into / removed from query results.
+         */
+        size_t insertions = 0;
+        size_t removals = 0;
+        /** Number of registered queries.
+         */
+        size_t queryCount = 0;
+    };
+
+    /** Persistent result of a signature query.
+     *
+     * Queries are owned by the EntityManager, which keeps their entity list in sync every time an
+     * entity signature changes. Iterating a query is O(matches), and the order of the entities is
+     * unspecified (it changes when entities leave the query).
+     */
+    class EntityQuery {
+        Signature m_Signature;
+        SparseSet m_Entities;
+
+        friend class ::EntityManager;
+
+    public:
+        explicit EntityQuery(const Signature &signature) : m_Signature(signature) {
+        }
+
+        EntityQuery(const EntityQuery &) = delete;
+
+        EntityQuery &operator=(const EntityQuery &) = delete;
+
+        [[nodiscard]] const Signature &GetSignature() const {
+            return m_Signature;
+        }
+
+        /** Checks whether an entity with the given signature belongs to this query.
+         */
+        [[nodiscard]] bool Matches(const Signature &signature) const {
+            return (signature & m_Signature) == m_Signature;
+        }
+
+        [[nodiscard]] bool Contains(const EntityID entity) const {
+            return m_Entities.Contains(entity);
+        }
+
+        [[nodiscard]] size_t Size() const {
+            return m_Entities.Size();
+        }
+
+        [[nodiscard]] bool Empty() const {
+            return m_Entities.Empty();
+        }
+
+        /** Returns any matching entity, or NULL_ENTITY if there is none.
+         */
+        [[nodiscard]] EntityID GetFirst() const {
+            return m_Entities.Empty() ? NULL_ENTITY : m_Entities.GetDense().front();
+        }
+
+        [[nodiscard]] auto begin() const {
+            return m_Entities.begin();
+        }
+
+        [[nodiscard]] auto end() const {
+            return m_Entities.end();
+        }
+    };
+}
+
+#endif //VEE_ENTITY_QUERY_H
@@ -0,0 +1,416 @@
+#ifndef VEE_FLAT_HIERARCHY_H
+#define VEE_FLAT_HIERARCHY_H
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "manager.h"
+#include "types.h"
+
+namespace Entities {
+    /** Parent/child relations of the entities of a world, stored in flat arrays.
+     *
+     * Links are kept per entity index (parent, first/last child, previous/next sibling), so reparenting only
+     * rewires a few indices: it does not allocate and costs O(depth) for the cycle check. The whole subtree
+     * follows its root.
+     *
+     * From the links, Refresh lays out every live entity in depth-first order in contiguous arrays: entity,
+     * position of the parent, depth and subtree size. Roots come in entity index order, and children come in
+     * the order they were attached. Parents always come before their children, and each subtree is a
+     * contiguous range starting at its root, so transform propagation, serialization and tree views are
+     * linear walks. The order is rebuilt in one pass, and only after the topology changed or entities were
+     * created or destroyed.
+     *
+     * Known gap: the flattened order is not maintained incrementally. A single reparent, spawn or despawn
+     * costs a full O(n) rebuild on the next Refresh, however small the affected subtree, so reparenting one
+     * leaf of a large world costs as much as laying out the whole world. Changes made between two refreshes
+     * share one rebuild. Moving only the subtree range would still shift every position between its old and
+     * new place, and users of the order would have to follow the shift (see TransformSystem::RemapCache).
+     *
+     * Owned by the ComponentManager, which keeps ParentComponent in sync with it (see ComponentManager::SetParent).
+     */
+    class FlatHierarchy {
+    public:
+        /** Parent position of roots in the flattened order.
+         */
+        static constexpr uint32_t NO_PARENT = ~0u;
+        /** Position of entities missing from the flattened order.
+         */
+        static constexpr uint32_t NO_POSITION = ~0u;
+
+    private:
+        struct Links {
+            /** Handle owning the links, NULL_ENTITY while the entity has never been linked.
+             */
+            EntityID entity = NULL_ENTITY;
+            EntityIndex parent = INVALID_ENTITY_INDEX;
+            EntityIndex firstChild = INVALID_ENTITY_INDEX;
+            EntityIndex lastChild = INVALID_ENTITY_INDEX;
+            EntityIndex previousSibling = INVALID_ENTITY_INDEX;
+            EntityIndex nextSibling = INVALID_ENTITY_INDEX;
+            uint32_t childCount = 0;
+        };
+
+        const EntityManager &m_EntityManager;
+        /** Indexed by entity index, grown on demand.
+         */
+        std::pmr::vector<Links> m_Links;
+
+        // Flattened depth-first order, see Refresh.
+        std::pmr::vector<EntityID> m_Entities;
+        std::pmr::vector<uint32_t> m_ParentPositions;
+        std::pmr::vector<uint32_t> m_Depths;
+        std::pmr::vector<uint32_t> m_SubtreeSizes;
+        /** Position of each entity index in the order.
+         */
+        std::pmr::vector<uint32_t> m_Positions;
+        uint32_t m_MaxDepth = 0;
+        /** Incremented every time the order is rebuilt.
+         */
+        uint64_t m_OrderVersion = 0;
+
+        std::atomic<bool> m_TopologyChanged = true;
+        /** EntityManager lifecycle version the order was built for.
+         */
+        std::atomic<uint64_t> m_OrderLifecycleVersion = 0;
+        std::mutex m_RefreshMutex;
+
+        [[nodiscard]] bool IsLinked(const EntityID entity) const {
+            const EntityIndex index = GetEntityIndex(entity);
+            return index < m_Links.size() && m_Links[index].entity == entity;
+        }
+
+        Links &Acquire(const EntityID entity) {
+            const EntityIndex index = GetEntityIndex(entity);
+            if (index >= m_Links.size()) {
+                m_Links.resize(index + 1);
+            }
+            auto &links = m_Links[index];
+            if (links.entity != entity) {
+                links = {};
+                links.entity = entity;
+            }
+            return links;
+        }
+
+        void Unlink(const EntityIndex index) {
+            auto &links = m_Links[index];
+            if (links.parent == INVALID_ENTITY_INDEX) {
+                return;
+            }
+
+            auto &parent = m_Links[links.parent];
+            if (links.previousSibling != INVALID_ENTITY_INDEX) {
+                m_Links[links.previousSibling].nextSibling = links.nextSibling;
+            } else {
+                parent.firstChild = links.nextSibling;
+            }
+            if (links.nextSibling != INVALID_ENTITY_INDEX) {
+                m_Links[links.nextSibling].previousSibling = links.previousSibling;
+            } else {
+                parent.lastChild = links.previousSibling;
+            }
+            --parent.childCount;
+
+            links.parent = INVALID_ENTITY_INDEX;
+            links.previousSibling = INVALID_ENTITY_INDEX;
+            links.nextSibling = INVALID_ENTITY_INDEX;
+        }
+
+        void Append(const EntityIndex index, const EntityIndex parentIndex) {
+            auto &links = m_Links[index];
+            auto &parent = m_Links[parentIndex];
+            links.parent = parentIndex;
+            links.previousSibling = parent.lastChild;
+            if (parent.lastChild != INVALID_ENTITY_INDEX) {
+                m_Links[parent.lastChild].nextSibling = index;
+            } else {
+                parent.firstChild = index;
+            }
+            parent.lastChild = index;
+            ++parent.childCount;
+        }
+
+        /** Appends an entity at the end of the order.
+         */
+        void Push(const EntityID entity, const uint32_t parentPosition, const uint32_t depth) {
+            m_Positions[GetEntityIndex(entity)] = static_cast<uint32_t>(m_Entities.size());
+            m_Entities.push_back(entity);
+            m_ParentPositions.push_back(parentPosition);
+            m_Depths.push_back(depth);
+            m_SubtreeSizes.push_back(1);
+            m_MaxDepth = std::max(m_MaxDepth, depth);
+        }
+
+        /** Appends the subtree of a root to the order, walking the links without recursion.
+         */
+        void AppendSubtree(const EntityID rootEntity) {
+            if (!IsLinked(rootEntity)) {
+                Push(rootEntity, NO_PARENT, 0);
+                return;
+            }
+
+            const EntityIndex root = GetEntityIndex(rootEntity);
+            EntityIndex index = root;
+            uint32_t depth = 0;
+            while (true) {
+                const auto &links = m_Links[index];
+                Push(links.entity, index == root ? NO_PARENT : m_Positions[links.parent], depth);
+                if (links.firstChild != INVALID_ENTITY_INDEX) {
+                    index = links.firstChild;
+                    ++depth;
+                    continue;
+                }
+
+                // Close the subtrees ending here, then move on to the next sibling.
+                while (true) {
+                    const uint32_t start = m_Positions[index];
+                    m_SubtreeSizes[start] = static_cast<uint32_t>(m_Entities.size()) - start;
+                    if (index == root) {
+                        return;
+                    }
+                    if (m_Links[index].nextSibling != INVALID_ENTITY_INDEX) {
+                        index = m_Links[index].nextSibling;
+                        break;
+                    }
+                    index = m_Links[index].parent;
+                    --depth;
+                }
+            }
+        }
+
+    public:
+        FlatHierarchy(const EntityManager &entityManager, std::pmr::memory_resource *resource)
+            : m_EntityManager(entityManager),
+              m_Links(resource),
+              m_Entities(resource),
+              m_ParentPositions(resource),
+              m_Depths(resource),
+              m_SubtreeSizes(resource),
+              m_Positions(resource) {
+        }
+
+        FlatHierarchy(const FlatHierarchy &) = delete;
+
+        FlatHierarchy &operator=(const FlatHierarchy &) = delete;
+
+        /** Returns the parent of the entity, or NULL_ENTITY for roots.
+         */
+        [[nodiscard]] EntityID GetParent(const EntityID entity) const {
+            if (!IsLinked(entity)) {
+                return NULL_ENTITY;
+            }
+            const EntityIndex parent = m_Links[GetEntityIndex(entity)].parent;
+            return parent == INVALID_ENTITY_INDEX ? NULL_ENTITY : m_Links[parent].entity;
+        }
+
+        [[nodiscard]] EntityID GetFirstChild(const EntityID entity) const {
+            if (!IsLinked(entity)) {
+                return NULL_ENTITY;
+            }
+            const EntityIndex child = m_Links[GetEntityIndex(entity)].firstChild;
+            return child == INVALID_ENTITY_INDEX ? NULL_ENTITY : m_Links[child].entity;
+        }
+
+        [[nodiscard]] EntityID GetNextSibling(const EntityID entity) const {
+            if (!IsLinked(entity)) {
+                return NULL_ENTITY;
+            }
+            const EntityIndex sibling = m_Links[GetEntityIndex(entity)].nextSibling;
+            return sibling == INVALID_ENTITY_INDEX ? NULL_ENTITY : m_Links[sibling].entity;
+        }
+
+        [[nodiscard]] uint32_t GetChildCount(const EntityID entity) const {
+            return IsLinked(entity) ? m_Links[GetEntityIndex(entity)].childCount : 0;
+        }
+
+        /** Calls `func(EntityID child)` for every direct child, in attachment order.
+         *  The hierarchy must not be modified by `func`.
+         */
+        template<typename Func>
+        void ForEachChild(const EntityID entity, Func &&func) const {
+            if (!IsLinked(entity)) {
+                return;
+            }
+            for (EntityIndex child = m_Links[GetEntityIndex(entity)].firstChild;
+                 child != INVALID_ENTITY_INDEX;
+                 child = m_Links[child].nextSibling) {
+                func(m_Links[child].entity);
+            }
+        }
+
+        /** Checks whether `ancestor` is a strict ancestor of `entity`, in O(depth).
+         */
+        [[nodiscard]] bool IsDescendantOf(const EntityID entity, const EntityID ancestor) const {
+            if (!IsLinked(entity) || !IsLinked(ancestor)) {
+                return false;
+            }
+            const EntityIndex ancestorIndex = GetEntityIndex(ancestor);
+            for (EntityIndex index = m_Links[GetEntityIndex(entity)].parent;
+                 index != INVALID_ENTITY_INDEX;
+                 index = m_Links[index].parent) {
+                if (index == ancestorIndex) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /** Moves the entity, with its whole subtree, under a new parent (appended after its last child), or
+         *  makes it a root when `parent` is NULL_ENTITY.
+         *
+         *  @throws std::runtime_error if an entity is not alive, or if the parent is the entity itself or one
+         *  of its descendants.
+         */
+        void SetParent(const EntityID child, const EntityID parent) {
+            if (!m_EntityManager.IsAlive(child)) {
+                throw std::runtime_error("Cannot set the parent of non-active entity: " + std::to_string(child));
+            }
+            if (parent != NULL_ENTITY) {
+                if (!m_EntityManager.IsAlive(parent)) {
+                    throw std::runtime_error("Cannot parent to non-active entity: " + std::to_string(parent));
+                }
+                if (parent == child || IsDescendantOf(parent, child)) {
+                    throw std::runtime_error("Parenting entity " + std::to_string(child) + " to " +
+                                             std::to_string(parent) + " would create a cycle");
+                }
+            }
+            if (GetParent(child) == parent) {
+                return;
+            }
+
+            const EntityIndex childIndex = GetEntityIndex(child);
+            Acquire(child);
+            Unlink(childIndex);
+            if (parent != NULL_ENTITY) {
+                Acquire(parent);
+                Append(childIndex, GetEntityIndex(parent));
+            }
+            m_TopologyChanged.store(true, std::memory_order_relaxed);
+        }
+
+        /** Forgets an entity that is being destroyed: it is detached from its parent, and its children become roots.
+         */
+        void RemoveEntity(const EntityID entity) {
+            if (!IsLinked(entity)) {
+                return;
+            }
+
+            const EntityIndex index = GetEntityIndex(entity);
+            Unlink(index);
+            for (EntityIndex child = m_Links[index].firstChild; child != INVALID_ENTITY_INDEX;) {
+                const EntityIndex next = m_Links[child].nextSibling;
+                auto &childLinks = m_Links[child];
+                childLinks.parent = INVALID_ENTITY_INDEX;
+                childLinks.previousSibling = INVALID_ENTITY_INDEX;
+                childLinks.nextSibling = INVALID_ENTITY_INDEX;
+                child = next;
+            }
+            m_Links[index] = {};
+            m_TopologyChanged.store(true, std::memory_order_relaxed);
+        }
+
+        /** Removes every link: all entities become roots.
+         */
+        void Clear() {
+            m_Links.clear();
+            m_TopologyChanged.store(true, std::memory_order_relaxed);
+        }
+
+        /** Rebuilds the whole flattened order, in O(n), if the topology changed or entities were created or
+         *  destroyed since the last call. Safe to call from several threads, as long as the hierarchy is not
+         *  being modified.
+         */
+        void Refresh() {
+            const uint64_t lifecycleVersion = m_EntityManager.GetLifecycleVersion();
+            if (!m_TopologyChanged.load(std::memory_order_acquire) &&
+                m_OrderLifecycleVersion.load(std::memory_order_acquire) == lifecycleVersion) {
+                return;
+            }
+
+            std::scoped_lock lock(m_RefreshMutex);
+            if (!m_TopologyChanged.load(std::memory_order_relaxed) &&
+                m_OrderLifecycleVersion.load(std::memory_order_relaxed) == lifecycleVersion) {
+                return;
+            }
+
+            const size_t count = m_EntityManager.GetActiveEntityCount();
+            m_Entities.clear();
+            m_ParentPositions.clear();
+            m_Depths.clear();
+            m_SubtreeSizes.clear();
+            m_Entities.reserve(count);
+            m_ParentPositions.reserve(count);
+            m_Depths.reserve(count);
+            m_SubtreeSizes.reserve(count);
+            m_Positions.assign(std::max(m_EntityManager.GetSlotCount(), m_Links.size()), NO_POSITION);
+            m_MaxDepth = 0;
+
+            for (const EntityID entity: m_EntityManager.GetActiveEntities()) {
+                if (!IsLinked(entity) || m_Links[GetEntityIndex(entity)].parent == INVALID_ENTITY_INDEX) {
+                    AppendSubtree(entity);
+                }
+            }
+
+            ++m_OrderVersion;
+            m_OrderLifecycleVersion.store(lifecycleVersion, std::memory_order_release);
+            m_TopologyChanged.store(false, std::memory_order_release);
+        }
+
+        /** Live entities in depth-first order. Valid after Refresh.
+         */
+        [[nodiscard]] const std::pmr::vector<EntityID> &GetEntities() const {
+            return m_Entities;
+        }
+
+        /** Position of the parent of each entity of the order, or NO_PARENT for roots. Valid after Refresh.
+         */
+        [[nodiscard]] const std::pmr::vector<uint32_t> &GetParentPositions() const {
+            return m_ParentPositions;
+        }
+
+        /** Depth of each entity of the order, 0 for roots. Valid after Refresh.
+         */
+        [[nodiscard]] const std::pmr::vector<uint32_t> &GetDepths() const {
+            return m_Depths;
+        }
+
+        /** Number of entities in the subtree of each entity of the order, itself included: the subtree of the
+         *  entity at `position` is the range [position, position + size). Valid after Refresh.
+         */
+        [[nodiscard]] const std::pmr::vector<uint32_t> &GetSubtreeSizes() const {
+            return m_SubtreeSizes;
+        }
+
+        /** Position of the entity in the order, or NO_POSITION. Valid after Refresh.
+         */
+        [[nodiscard]] uint32_t GetPosition(const EntityID entity) const {
+            const EntityIndex index = GetEntityIndex(entity);
+            if (index >= m_Positions.size() || m_Positions[index] == NO_POSITION ||
+                m_Entities[m_Positions[index]] != entity) {
+                return NO_POSITION;
+            }
+            return m_Positions[index];
+        }
+
+        /** Incremented every time Refresh rebuilds the order: data cached per position stays valid as long as
+         *  it does not change.
+         */
+        [[nodiscard]] uint64_t GetOrderVersion() const {
+            return m_OrderVersion;
+        }
+
+        /** Depth of the deepest entity of the order. Valid after Refresh.
+         */
+        [[nodiscard]] uint32_t GetMaxDepth() const {
+            return m_MaxDepth;
+        }
+    };
+}
+
+#endif //VEE_FLAT_HIERARCHY_H
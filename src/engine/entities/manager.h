@@ -1,55 +1,224 @@
 #ifndef GAME_ENGINE_ENTITY_H
 #define GAME_ENGINE_ENTITY_H
+#include <algorithm>
 #include <bitset>
 #include <iostream>
-#include <set>
+#include <stdexcept>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
+#include "component_bitmap_index.h"
+#include "entity_query.h"
 #include "types.h"
 #include "../utils/entity_utils.h"
+#include "../utils/memory_arena.h"
+#include "../utils/paged_vector.h"
+#include "../utils/string_pool.h"
 
 using namespace Entities;
 
-constexpr size_t MAX_ENTITIES = 10000;
-
 constexpr size_t MAX_COMPONENTS = COMPONENTS_COUNT;
 
-struct EntityData {
-    EntityID id;
-    std::string name;
+/** Bookkeeping for one entity index.
+ *
+ * Free slots are chained in an intrusive doubly-linked list so that both the next free index
+ * and an arbitrary index (requested through CreateEntity with a custom ID) can be claimed in O(1).
+ */
+struct EntitySlot {
+    /** Generation of the live handle, or of the handle that will be issued next if the slot is free.
+     */
+    EntityGeneration generation = 0;
+    EntityIndex previousFree = INVALID_ENTITY_INDEX;
+    EntityIndex nextFree = INVALID_ENTITY_INDEX;
 };
 
-class AvailableEntityQueue : public std::queue<EntityID> {
+class EntityManager {
 public:
-    /** Removes a specific EntityID from the queue.
-     *  This is an O(n) operation.
-     */
-    void pop_value(const EntityID entityID) {
-        std::queue<EntityID> tempQueue;
-        while (!this->empty()) {
-            EntityID currentID = this->front();
-            this->pop();
-            if (currentID != entityID) {
-                tempQueue.push(currentID);
+    /** Copy of the entity tables, see CaptureTables.
+     */
+    struct TableSnapshot {
+        std::vector<EntitySlot> slots;
+        std::vector<EntityID> handles;
+        std::vector<Signature> signatures;
+        /** Names are kept as ids of the name pool, which never forgets a string.
+         */
+        std::vector<Utils::StringPool::StringId> names;
+        EntityIndex freeListHead = INVALID_ENTITY_INDEX;
+        size_t activeEntityCount = 0;
+    };
+
+private:
+    /** Arena of the scene, shared with the ComponentManager. Declared first: it must outlive every table.
+     */
+    std::shared_ptr<Utils::MemoryArena> m_MemoryArena;
+
+    // All the tables below are indexed by entity index. Index 0 is reserved for NULL_ENTITY.
+    // They grow one page at a time, so the number of entities is only bounded by the index bits
+    // of EntityID, and existing entries are never copied when the world grows.
+    PagedVector<EntitySlot> m_Slots;
+    /** Live handle of each index, or NULL_ENTITY if the slot is free.
+     */
+    PagedVector<EntityID> m_Handles;
+    PagedVector<Signature> m_Signatures;
+    /** Interned name of each entity, see m_NamePool.
+     */
+    PagedVector<Utils::StringPool::StringId> m_Names;
+    Utils::StringPool m_NamePool;
+    /** Column-wise copy of the signatures and live slots, used by ScanEntitiesWithSignature.
+     */
+    ComponentBitmapIndex m_ComponentBitmaps;
+
+    EntityIndex m_FreeListHead = INVALID_ENTITY_INDEX;
+    size_t m_ActiveEntityCount = 0;
+    /** Incremented whenever the set of live entities changes, see GetLifecycleVersion.
+     */
+    uint64_t m_LifecycleVersion = 0;
+
+    // Cached queries, kept up to date on every signature change.
+    std::unordered_map<Signature, std::unique_ptr<EntityQuery> > m_Queries;
+    std::vector<EntityQuery *> m_QueryList;
+    EntityQueryStatistics m_QueryStatistics;
+
+    void AddToQueries(const EntityID entity, const Signature &signature) {
+        for (const auto query: m_QueryList) {
+            ++m_QueryStatistics.signatureChecks;
+            if (query->Matches(signature)) {
+                query->m_Entities.Insert(entity);
+                ++m_QueryStatistics.insertions;
             }
         }
-        std::swap(*this, tempQueue);
     }
-};
 
-class EntityManager {
-    AvailableEntityQueue m_AvailableEntityIDs;
-    std::vector<Signature> m_Signatures;
-    std::vector<EntityData> m_Entities;
-    std::set<EntityID> m_ActiveEntities;
+    void RemoveFromQueries(const EntityID entity, const Signature &signature) {
+        for (const auto query: m_QueryList) {
+            ++m_QueryStatistics.signatureChecks;
+            if (query->Matches(signature)) {
+                query->m_Entities.Remove(entity);
+                ++m_QueryStatistics.removals;
+            }
+        }
+    }
 
-public:
-    EntityManager() {
-        for (EntityID offset = 0; offset < MAX_ENTITIES; ++offset) {
-            m_AvailableEntityIDs.push(STARTING_ENTITY_ID + offset);
+    /** Moves a live entity in or out of the cached queries affected by a signature change.
+     */
+    void UpdateQueries(const EntityID entity, const Signature &previous, const Signature &current) {
+        for (const auto query: m_QueryList) {
+            ++m_QueryStatistics.signatureChecks;
+            const bool wasMatching = query->Matches(previous);
+            const bool isMatching = query->Matches(current);
+            if (wasMatching == isMatching) {
+                continue;
+            }
+            if (isMatching) {
+                query->m_Entities.Insert(entity);
+                ++m_QueryStatistics.insertions;
+            } else {
+                query->m_Entities.Remove(entity);
+                ++m_QueryStatistics.removals;
+            }
+        }
+    }
+
+    void PushFreeSlot(const EntityIndex index) {
+        auto &slot = m_Slots[index];
+        slot.previousFree = INVALID_ENTITY_INDEX;
+        slot.nextFree = m_FreeListHead;
+        if (m_FreeListHead != INVALID_ENTITY_INDEX) {
+            m_Slots[m_FreeListHead].previousFree = index;
+        }
+        m_FreeListHead = index;
+    }
+
+    void UnlinkFreeSlot(const EntityIndex index) {
+        auto &slot = m_Slots[index];
+        if (slot.previousFree != INVALID_ENTITY_INDEX) {
+            m_Slots[slot.previousFree].nextFree = slot.nextFree;
+        } else {
+            m_FreeListHead = slot.nextFree;
+        }
+        if (slot.nextFree != INVALID_ENTITY_INDEX) {
+            m_Slots[slot.nextFree].previousFree = slot.previousFree;
+        }
+        slot.previousFree = INVALID_ENTITY_INDEX;
+        slot.nextFree = INVALID_ENTITY_INDEX;
+    }
+
+    /** Appends a new, unlinked slot at the end of the tables.
+     */
+    EntityIndex AppendSlot() {
+        const auto index = static_cast<EntityIndex>(m_Slots.Size());
+        if (index > ENTITY_INDEX_MASK) {
+            throw std::runtime_error("Entity index space exhausted: " + std::to_string(index));
+        }
+        m_Slots.PushBack({});
+        m_Handles.PushBack(NULL_ENTITY);
+        m_Signatures.PushBack({});
+        m_Names.PushBack(Utils::StringPool::EMPTY_STRING);
+        return index;
+    }
+
+    /** Generation following `generation`, skipping the one reserved for pending entities.
+     */
+    static EntityGeneration NextGeneration(const EntityGeneration generation) {
+        const auto next = static_cast<EntityGeneration>(generation + 1);
+        return next == PENDING_ENTITY_GENERATION ? 0 : next;
+    }
+
+    /** Claims a free index, from the free list or by growing the tables.
+     */
+    EntityIndex AcquireSlot() {
+        EntityIndex index = m_FreeListHead;
+        if (index != INVALID_ENTITY_INDEX) {
+            UnlinkFreeSlot(index);
+        } else {
+            index = AppendSlot();
         }
-        m_Signatures.resize(MAX_ENTITIES, 0);
-        m_Entities.reserve(MAX_ENTITIES);
+        return index;
+    }
+
+    /** Makes the slot live with the given signature, without registering it in the cached queries.
+     */
+    EntityID ActivateSlotUnqueried(
+        const EntityIndex index,
+        const Utils::StringPool::StringId name,
+        const Signature &signature
+    ) {
+        const EntityID handle = MakeEntityID(index, m_Slots[index].generation);
+        m_Handles[index] = handle;
+        m_Signatures[index] = signature;
+        m_Names[index] = name;
+        m_ComponentBitmaps.SetAlive(index, true);
+        m_ComponentBitmaps.UpdateSignature(index, {}, signature);
+        ++m_ActiveEntityCount;
+        ++m_LifecycleVersion;
+        return handle;
+    }
+
+    EntityID ActivateSlot(const EntityIndex index, const std::string_view name) {
+        const EntityID handle = ActivateSlotUnqueried(index, m_NamePool.Intern(name), {});
+        AddToQueries(handle, {});
+        return handle;
+    }
+
+public:
+    /** @param memoryArena Arena the entity tables (and the components of the scene) are allocated from.
+     */
+    explicit EntityManager(std::shared_ptr<Utils::MemoryArena> memoryArena = std::make_shared<Utils::MemoryArena>())
+        : m_MemoryArena(std::move(memoryArena)),
+          m_Slots(m_MemoryArena.get()),
+          m_Handles(m_MemoryArena.get()),
+          m_Signatures(m_MemoryArena.get()),
+          m_Names(m_MemoryArena.get()),
+          m_NamePool(m_MemoryArena.get()) {
+        // Reserve index 0 so that NULL_ENTITY never refers to a live entity.
+        AppendSlot();
+    }
+
+    [[nodiscard]] const std::shared_ptr<Utils::MemoryArena> &GetMemoryArena() const {
+        return m_MemoryArena;
     }
 
     /** Creates a new entity with a unique ID.
@@ -57,90 +226,282 @@ public:
      *
      *  @return The EntityID of the newly created entity.
      */
-    EntityID CreateEntity(const std::string &name) {
-        const EntityID newID = m_AvailableEntityIDs.front();
-        m_Entities.emplace_back(newID, name);
-        m_Signatures[newID - STARTING_ENTITY_ID] = 0;
-        m_ActiveEntities.insert(newID);
-        m_AvailableEntityIDs.pop();
-        return newID;
+    EntityID CreateEntity(const std::string_view name) {
+        return ActivateSlot(AcquireSlot(), name);
+    }
+
+    /** Creates `count` entities sharing the same name and initial signature.
+     *
+     *  The cached queries matching the signature are looked up once for the whole range.
+     *  Note that the signature is only bookkeeping: the caller is responsible for storing the components.
+     *
+     *  @return The handles of the new entities, in creation order.
+     */
+    std::vector<EntityID> CreateEntities(const size_t count, const std::string_view name, const Signature &signature) {
+        std::vector<EntityQuery *> matchingQueries;
+        for (const auto query: m_QueryList) {
+            ++m_QueryStatistics.signatureChecks;
+            if (query->Matches(signature)) {
+                query->m_Entities.Reserve(query->Size() + count);
+                matchingQueries.push_back(query);
+            }
+        }
+
+        const auto nameId = m_NamePool.Intern(name);
+        std::vector<EntityID> entities;
+        entities.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            const EntityID entity = ActivateSlotUnqueried(AcquireSlot(), nameId, signature);
+            for (const auto query: matchingQueries) {
+                query->m_Entities.Insert(entity);
+            }
+            entities.push_back(entity);
+        }
+        m_QueryStatistics.insertions += count * matchingQueries.size();
+
+        return entities;
     }
 
     /** Creates a new entity with a custom ID.
      *
-     *  This overload is mainly intended for deserialization purposes where speed is not critical.
+     *  This overload is mainly intended for deserialization purposes. Both the index and the generation
+     *  of the given handle are preserved so that references between saved entities stay valid.
+     *  Claiming the index is O(1); indices skipped while growing the tables become available for reuse.
      *
      *  @param name The name of the new entity.
      *  @param customEntityId The custom EntityID to assign to the new entity.
      *  @return The EntityID of the newly created entity.
-     *  @throws std::runtime_error if the customEntityId is out of range or already in use.
+     *  @throws std::runtime_error if the customEntityId is NULL_ENTITY or already in use.
      */
-    EntityID CreateEntity(const std::string &name, const EntityID customEntityId) {
+    EntityID CreateEntity(const std::string_view name, const EntityID customEntityId) {
+        const EntityIndex index = GetEntityIndex(customEntityId);
+
         // Sanity checks
-        if (customEntityId < STARTING_ENTITY_ID || customEntityId >= STARTING_ENTITY_ID + MAX_ENTITIES) {
+        if (index < STARTING_ENTITY_ID) {
             throw std::runtime_error("Custom EntityID out of range: " + std::to_string(customEntityId));
         }
-        if (m_ActiveEntities.contains(customEntityId)) {
+        if (index < m_Handles.Size() && m_Handles[index] != NULL_ENTITY) {
             throw std::runtime_error("Custom EntityID already in use: " + std::to_string(customEntityId));
         }
+        if (GetEntityGeneration(customEntityId) == PENDING_ENTITY_GENERATION) {
+            throw std::runtime_error("Custom EntityID uses the reserved pending generation: " +
+                                     std::to_string(customEntityId));
+        }
+
+        while (m_Slots.Size() <= index) {
+            PushFreeSlot(AppendSlot());
+        }
+
+        UnlinkFreeSlot(index);
+        m_Slots[index].generation = GetEntityGeneration(customEntityId);
+        return ActivateSlot(index, name);
+    }
+
+    /** Checks whether the handle refers to a live entity.
+     *  Handles of destroyed entities are rejected even after their index has been reused.
+     */
+    [[nodiscard]] bool IsAlive(const EntityID entityID) const {
+        const EntityIndex index = GetEntityIndex(entityID);
+        return entityID != NULL_ENTITY && index < m_Handles.Size() && m_Handles[index] == entityID;
+    }
 
-        m_Entities.emplace_back(customEntityId, name);
-        m_Signatures[customEntityId - STARTING_ENTITY_ID] = 0;
-        m_ActiveEntities.insert(customEntityId);
+    /** Returns the cached query of the live entities whose signature contains the given one.
+     *
+     *  The first call for a signature registers the query and populates it with a full scan; the query is
+     *  then maintained incrementally and later calls return it in O(1). The returned reference stays valid
+     *  for the lifetime of the EntityManager.
+     */
+    [[nodiscard]] const EntityQuery &GetEntitiesWithSignature(const Signature &signature) {
+        if (const auto it = m_Queries.find(signature); it != m_Queries.end()) {
+            ++m_QueryStatistics.hits;
+            return *it->second;
+        }
 
-        // Small optimization: if the custom ID is the next available one, just pop it.
-        if (customEntityId == m_AvailableEntityIDs.front()) {
-            m_AvailableEntityIDs.pop();
-            return customEntityId;
+        ++m_QueryStatistics.misses;
+        auto query = std::make_unique<EntityQuery>(signature);
+        for (const auto entity: ScanEntitiesWithSignature(signature)) {
+            query->m_Entities.Insert(entity);
         }
 
-        // Otherwise, remove it from the available IDs queue. This is an O(n) operation.
-        m_AvailableEntityIDs.pop_value(customEntityId);
-        return customEntityId;
+        const auto queryPtr = query.get();
+        m_Queries.emplace(signature, std::move(query));
+        m_QueryList.push_back(queryPtr);
+        return *queryPtr;
+    }
+
+    /** Scans every entity slot for signatures containing the given one, without registering a query.
+     *  The scan ANDs the component bitmaps 256 entities at a time, so its cost is O(capacity / 256) plus
+     *  O(matches): prefer GetEntitiesWithSignature for lookups that happen repeatedly.
+     */
+    [[nodiscard]] Utils::Entities::EntityMatchRange ScanEntitiesWithSignature(const Signature &signature) const {
+        return {&m_ComponentBitmaps, &m_Handles, signature};
+    }
+
+    [[nodiscard]] EntityQueryStatistics GetQueryStatistics() const {
+        auto statistics = m_QueryStatistics;
+        statistics.queryCount = m_QueryList.size();
+        return statistics;
     }
 
-    [[nodiscard]] Utils::Entities::EntityMatchRange GetEntitiesWithSignature(const Signature &signature) {
-        return {&m_Signatures, signature};
+    void ResetQueryStatistics() {
+        m_QueryStatistics = {};
     }
 
     void SetSignature(const EntityID entityID, const Signature signature) {
-        m_Signatures[entityID - STARTING_ENTITY_ID] = signature;
+        auto &current = m_Signatures[GetEntityIndex(entityID)];
+        if (!m_QueryList.empty() && m_Handles[GetEntityIndex(entityID)] == entityID) {
+            UpdateQueries(entityID, current, signature);
+        }
+        m_ComponentBitmaps.UpdateSignature(GetEntityIndex(entityID), current, signature);
+        current = signature;
     }
 
     [[nodiscard]] Signature GetSignature(const EntityID entityID) const {
-        if (!m_ActiveEntities.contains(entityID)) {
+        if (!IsAlive(entityID)) {
             throw std::runtime_error(
                 "Trying to get signature of non-active entity: " + std::to_string(entityID));
         }
-        return m_Signatures[entityID - STARTING_ENTITY_ID];
+        return m_Signatures[GetEntityIndex(entityID)];
     }
 
-    [[nodiscard]] std::vector<EntityData> GetAllEntities() const {
-        std::vector<EntityData> entities;
-        entities.reserve(m_ActiveEntities.size());
-        for (const EntityID entityID: m_ActiveEntities) {
-            entities.push_back(m_Entities[entityID - STARTING_ENTITY_ID]);
-        }
-        return entities;
+    /** Returns the signature of an entity without checking that it is alive.
+     *  Intended for iteration paths where the entity comes from component storage.
+     */
+    [[nodiscard]] const Signature &GetSignatureUnchecked(const EntityID entityID) const {
+        return m_Signatures[GetEntityIndex(entityID)];
+    }
+
+    /** Iterates over every live entity, in index order, without allocating.
+     *
+     *  Entities must not be created or destroyed while iterating.
+     */
+    [[nodiscard]] Utils::Entities::EntityMatchRange GetActiveEntities() const {
+        return ScanEntitiesWithSignature({});
+    }
+
+    [[nodiscard]] size_t GetActiveEntityCount() const {
+        return m_ActiveEntityCount;
+    }
+
+    /** Number of entity indices in use or available for reuse, index 0 included: every live entity has an
+     *  index below it.
+     */
+    [[nodiscard]] size_t GetSlotCount() const {
+        return m_Handles.Size();
+    }
+
+    /** Counter incremented every time an entity is created or destroyed (or the tables are restored), so that
+     *  structures derived from the set of live entities can tell when to rebuild.
+     */
+    [[nodiscard]] uint64_t GetLifecycleVersion() const {
+        return m_LifecycleVersion;
     }
 
-    void RenameEntity(const EntityID entity, const std::string &newName) {
-        m_Entities[entity - STARTING_ENTITY_ID].name = newName;
+    void RenameEntity(const EntityID entity, const std::string_view newName) {
+        m_Names[GetEntityIndex(entity)] = m_NamePool.Intern(newName);
     }
 
-    /** Deletes an entity, making its ID available for reuse.
+    /** Deletes an entity, making its index available for reuse under the next generation.
+     *
+     *  @throws std::runtime_error if the entity is not alive.
      */
     void RemoveEntity(const EntityID entity) {
-        m_AvailableEntityIDs.push(entity);
-        m_Signatures[entity - STARTING_ENTITY_ID].reset();
-        m_ActiveEntities.erase(entity);
+        if (!IsAlive(entity)) {
+            throw std::runtime_error("Trying to remove non-active entity: " + std::to_string(entity));
+        }
+
+        const EntityIndex index = GetEntityIndex(entity);
+        RemoveFromQueries(entity, m_Signatures[index]);
+        m_ComponentBitmaps.UpdateSignature(index, m_Signatures[index], {});
+        m_ComponentBitmaps.SetAlive(index, false);
+        m_Handles[index] = NULL_ENTITY;
+        m_Signatures[index].reset();
+        m_Names[index] = Utils::StringPool::EMPTY_STRING;
+        m_Slots[index].generation = NextGeneration(m_Slots[index].generation);
+        --m_ActiveEntityCount;
+        ++m_LifecycleVersion;
+
+        PushFreeSlot(index);
     }
 
-    /** Returns a reference to the name of the entity.
+    /** Returns the name of the entity. The view stays valid after renames and its `data()` is null-terminated.
      */
-    std::string &GetEntityName(const EntityID entity) {
-        return m_Entities[entity - STARTING_ENTITY_ID].name;
-    };
+    [[nodiscard]] std::string_view GetEntityName(const EntityID entity) const {
+        return m_NamePool.Get(m_Names[GetEntityIndex(entity)]);
+    }
+
+    /** Returns the interned name of the entity: entities with the same name share the same id.
+     */
+    [[nodiscard]] Utils::StringPool::StringId GetEntityNameId(const EntityID entity) const {
+        return m_Names[GetEntityIndex(entity)];
+    }
+
+    [[nodiscard]] const Utils::StringPool &GetNamePool() const {
+        return m_NamePool;
+    }
+
+    /** Copies the entity tables (handles, generations, free list, signatures and names).
+     */
+    [[nodiscard]] TableSnapshot CaptureTables() const {
+        TableSnapshot snapshot;
+        m_Slots.CopyTo(snapshot.slots);
+        m_Handles.CopyTo(snapshot.handles);
+        m_Signatures.CopyTo(snapshot.signatures);
+        m_Names.CopyTo(snapshot.names);
+        snapshot.freeListHead = m_FreeListHead;
+        snapshot.activeEntityCount = m_ActiveEntityCount;
+        return snapshot;
+    }
+
+    /** Replaces the entity tables with a copy taken by CaptureTables on this manager, then rebuilds the
+     *  component bitmaps and the cached queries.
+     *
+     *  Handles captured alive are restored as they were. Every other slot, including the ones appended after
+     *  the capture, becomes free with the generation it would have had in the live world, so handles issued
+     *  after the capture are stale and never handed out again.
+     */
+    void RestoreTables(const TableSnapshot &snapshot) {
+        const size_t liveSize = m_Slots.Size();
+        std::vector<EntityGeneration> liveGenerations(liveSize);
+        for (EntityIndex index = 0; index < liveSize; ++index) {
+            const EntityGeneration generation = m_Slots[index].generation;
+            liveGenerations[index] = m_Handles[index] != NULL_ENTITY ? NextGeneration(generation) : generation;
+        }
+
+        m_Slots.Assign(snapshot.slots);
+        m_Handles.Assign(snapshot.handles);
+        m_Signatures.Assign(snapshot.signatures);
+        m_Names.Assign(snapshot.names);
+        m_FreeListHead = snapshot.freeListHead;
+        m_ActiveEntityCount = snapshot.activeEntityCount;
+        ++m_LifecycleVersion;
+
+        for (EntityIndex index = STARTING_ENTITY_ID; index < std::min(liveSize, snapshot.slots.size()); ++index) {
+            if (m_Handles[index] == NULL_ENTITY) {
+                m_Slots[index].generation = liveGenerations[index];
+            }
+        }
+        for (auto index = static_cast<EntityIndex>(snapshot.slots.size()); index < liveSize; ++index) {
+            AppendSlot();
+            m_Slots[index].generation = liveGenerations[index];
+            PushFreeSlot(index);
+        }
+
+        m_ComponentBitmaps.Clear();
+        for (EntityIndex index = STARTING_ENTITY_ID; index < m_Handles.Size(); ++index) {
+            if (m_Handles[index] != NULL_ENTITY) {
+                m_ComponentBitmaps.SetAlive(index, true);
+                m_ComponentBitmaps.UpdateSignature(index, {}, m_Signatures[index]);
+            }
+        }
+
+        for (const auto query: m_QueryList) {
+            query->m_Entities.Clear();
+            for (const auto entity: ScanEntitiesWithSignature(query->GetSignature())) {
+                query->m_Entities.Insert(entity);
+            }
+        }
+    }
 };
 
 #endif //GAME_ENGINE_ENTITY_H
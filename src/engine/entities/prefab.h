@@ -0,0 +1,130 @@
+#ifndef VEE_PREFAB_H
+#define VEE_PREFAB_H
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "types.h"
+#include "components_system/component_base.h"
+#include "components_system/component_column.h"
+#include "components_system/components/parent_component.h"
+
+namespace Entities {
+    /** Template of an entity, or of a hierarchy of entities, that can be instantiated many times
+     * (see ComponentManager::InstantiatePrefab).
+     *
+     * Component values are packed per type. Hierarchy links are stored as prefab entity indices:
+     * a prefab entity can only have a parent added before it, and the instances are linked (with their
+     * ParentComponent filled in) with the new entity IDs at instantiation.
+     */
+    class Prefab {
+    public:
+        static constexpr uint32_t NO_PARENT = ~0u;
+
+        struct Entity {
+            std::string name;
+            uint32_t parent = NO_PARENT;
+            std::vector<uint32_t> children;
+            Signature signature;
+            /** Row of each component in its column, for the stored (non-tag) components of the signature.
+             */
+            std::array<uint32_t, COMPONENTS_COUNT> rows{};
+        };
+
+    private:
+        std::vector<Entity> m_Entities;
+        std::array<std::unique_ptr<ComponentColumn>, COMPONENTS_COUNT> m_Columns;
+
+        [[nodiscard]] Entity &At(const uint32_t index) {
+            if (index >= m_Entities.size()) {
+                throw std::runtime_error("Prefab entity index out of range: " + std::to_string(index));
+            }
+            return m_Entities[index];
+        }
+
+    public:
+        Prefab() = default;
+
+        Prefab(Prefab &&) = default;
+
+        Prefab &operator=(Prefab &&) = default;
+
+        /** Adds an entity to the prefab, optionally as a child of a previously added entity.
+         *
+         * @return The index of the new prefab entity.
+         */
+        uint32_t AddEntity(const std::string &name, const uint32_t parent = NO_PARENT) {
+            if (parent != NO_PARENT && parent >= m_Entities.size()) {
+                throw std::runtime_error("Prefab parent index out of range: " + std::to_string(parent));
+            }
+
+            const auto index = static_cast<uint32_t>(m_Entities.size());
+            m_Entities.emplace_back().name = name;
+
+            if (parent != NO_PARENT) {
+                m_Entities[parent].children.push_back(index);
+                m_Entities[index].parent = parent;
+                AddComponent(index, ParentComponent{});
+            }
+            return index;
+        }
+
+        /** Adds (or replaces) a component of a prefab entity.
+         */
+        template<typename T>
+        void AddComponent(const uint32_t index, const T &component) {
+            if constexpr (IS_TAG_COMPONENT<T>) {
+                AddTag(index, ComponentTypeHelper<T>::ID);
+            } else {
+                AddComponentCopy(index, ComponentInfo::Of<T>(), &component);
+            }
+        }
+
+        /** Adds (or replaces) a copy of the component at `component`, described by `info`.
+         */
+        void AddComponentCopy(const uint32_t index, const ComponentInfo &info, const void *component) {
+            auto &entity = At(index);
+            auto &column = m_Columns[info.typeId];
+            if (!column) {
+                column = std::make_unique<ComponentColumn>(info);
+            }
+
+            if (entity.signature.test(info.typeId)) {
+                column->Replace(entity.rows[info.typeId], component);
+                return;
+            }
+            entity.rows[info.typeId] = column->Push(component);
+            entity.signature.set(info.typeId);
+        }
+
+        /** Adds a tag component, which only exists in the signature.
+         */
+        void AddTag(const uint32_t index, const ComponentTypeId typeId) {
+            At(index).signature.set(typeId);
+        }
+
+        [[nodiscard]] size_t Size() const {
+            return m_Entities.size();
+        }
+
+        [[nodiscard]] const std::vector<Entity> &GetEntities() const {
+            return m_Entities;
+        }
+
+        /** Returns the stored value of a component of a prefab entity, or nullptr for tags and missing components.
+         */
+        [[nodiscard]] const void *GetComponent(const uint32_t index, const ComponentTypeId typeId) const {
+            const auto &entity = m_Entities[index];
+            if (!entity.signature.test(typeId) || !m_Columns[typeId]) {
+                return nullptr;
+            }
+            return m_Columns[typeId]->Get(entity.rows[typeId]);
+        }
+    };
+}
+
+#endif //VEE_PREFAB_H
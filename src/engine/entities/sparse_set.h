@@ -0,0 +1,155 @@
+#ifndef VEE_SPARSE_SET_H
+#define VEE_SPARSE_SET_H
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#include "types.h"
+
+namespace Entities {
+    /** Number of entries in a single page of the sparse index.
+     */
+    constexpr size_t SPARSE_PAGE_SIZE = 4096;
+
+    /** Set of entities with O(1) insertion, removal and lookup.
+     *
+     * The sparse index maps an entity index to its position in the packed dense array. It is split in
+     * fixed-size pages that are only allocated when an entity of that range is inserted, so large
+     * but sparsely populated ID ranges stay cheap. Removal swaps the last dense element into the
+     * hole, keeping the dense array packed for iteration.
+     *
+     * The dense array stores full handles, so lookups with a stale handle (older generation of a
+     * reused index) miss. Both the pages and the dense array are allocated from the memory resource
+     * given at construction.
+     */
+    class SparseSet {
+    public:
+        static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+    private:
+        using Page = std::array<uint32_t, SPARSE_PAGE_SIZE>;
+
+        std::pmr::polymorphic_allocator<Page> m_PageAllocator;
+        std::pmr::vector<Page *> m_Pages;
+        std::pmr::vector<EntityID> m_Dense;
+
+        Page &GetOrCreatePage(const size_t pageIndex) {
+            if (pageIndex >= m_Pages.size()) {
+                m_Pages.resize(pageIndex + 1, nullptr);
+            }
+            if (!m_Pages[pageIndex]) {
+                m_Pages[pageIndex] = m_PageAllocator.allocate(1);
+                m_Pages[pageIndex]->fill(INVALID_INDEX);
+            }
+            return *m_Pages[pageIndex];
+        }
+
+        /** Sparse slot of an entity whose page is known to exist.
+         */
+        uint32_t &SparseEntry(const EntityID entity) {
+            const EntityIndex entityIndex = GetEntityIndex(entity);
+            return (*m_Pages[entityIndex / SPARSE_PAGE_SIZE])[entityIndex % SPARSE_PAGE_SIZE];
+        }
+
+    public:
+        explicit SparseSet(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : m_PageAllocator(resource), m_Pages(resource), m_Dense(resource) {
+        }
+
+        SparseSet(const SparseSet &) = delete;
+
+        SparseSet &operator=(const SparseSet &) = delete;
+
+        ~SparseSet() {
+            for (Page *page: m_Pages) {
+                if (page) {
+                    m_PageAllocator.deallocate(page, 1);
+                }
+            }
+        }
+
+        /** Returns the dense index of the entity, or INVALID_INDEX if it is not in the set.
+         */
+        [[nodiscard]] uint32_t IndexOf(const EntityID entity) const {
+            const EntityIndex entityIndex = GetEntityIndex(entity);
+            const size_t pageIndex = entityIndex / SPARSE_PAGE_SIZE;
+            if (pageIndex >= m_Pages.size() || !m_Pages[pageIndex]) {
+                return INVALID_INDEX;
+            }
+            const uint32_t index = (*m_Pages[pageIndex])[entityIndex % SPARSE_PAGE_SIZE];
+            return index != INVALID_INDEX && m_Dense[index] == entity ? index : INVALID_INDEX;
+        }
+
+        [[nodiscard]] bool Contains(const EntityID entity) const {
+            return IndexOf(entity) != INVALID_INDEX;
+        }
+
+        /** Appends the entity to the dense array.
+         * The entity must not already be in the set.
+         *
+         * @return The dense index of the inserted entity.
+         */
+        uint32_t Insert(const EntityID entity) {
+            const auto index = static_cast<uint32_t>(m_Dense.size());
+            const EntityIndex entityIndex = GetEntityIndex(entity);
+            GetOrCreatePage(entityIndex / SPARSE_PAGE_SIZE)[entityIndex % SPARSE_PAGE_SIZE] = index;
+            m_Dense.push_back(entity);
+            return index;
+        }
+
+        /** Removes the entity by moving the last dense element into its slot.
+         * The entity must be in the set.
+         *
+         * @return The dense index that was vacated; callers keeping parallel arrays must apply the same swap.
+         */
+        uint32_t Remove(const EntityID entity) {
+            const uint32_t index = IndexOf(entity);
+            const EntityID last = m_Dense.back();
+
+            m_Dense[index] = last;
+            SparseEntry(last) = index;
+            SparseEntry(entity) = INVALID_INDEX;
+            m_Dense.pop_back();
+
+            return index;
+        }
+
+        void Reserve(const size_t capacity) {
+            m_Dense.reserve(capacity);
+        }
+
+        void Clear() {
+            for (const auto entity: m_Dense) {
+                SparseEntry(entity) = INVALID_INDEX;
+            }
+            m_Dense.clear();
+        }
+
+        [[nodiscard]] size_t Size() const {
+            return m_Dense.size();
+        }
+
+        [[nodiscard]] bool Empty() const {
+            return m_Dense.empty();
+        }
+
+        /** Returns the packed array of entities, in storage order.
+         */
+        [[nodiscard]] const std::pmr::vector<EntityID> &GetDense() const {
+            return m_Dense;
+        }
+
+        [[nodiscard]] std::pmr::vector<EntityID>::const_iterator begin() const {
+            return m_Dense.begin();
+        }
+
+        [[nodiscard]] std::pmr::vector<EntityID>::const_iterator end() const {
+            return m_Dense.end();
+        }
+    };
+}
+
+#endif //VEE_SPARSE_SET_H
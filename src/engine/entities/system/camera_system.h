@@ -28,7 +28,7 @@ public:
     [[nodiscard]] EntityID GetActiveCameraId() const {
         std::optional<EntityID> activeCameraId;
 
-        if (!m_Entities.empty()) {
+        if (!m_Entities.Empty()) {
             activeCameraId = *m_Entities.begin();
         }
 
@@ -43,7 +43,7 @@ public:
         return activeCameraId.value();
     }
 
-    virtual glm::mat4 ComputeViewMatrix(LocalTransformComponent &transform) {
+    virtual glm::mat4 ComputeViewMatrix(const LocalTransformComponent &transform) {
         const glm::mat4 M_world = glm::translate(glm::mat4_cast(transform.rotation), transform.position);
 
         return glm::inverse(M_world);
@@ -74,6 +74,21 @@ public:
     virtual void UpdateCamera(CameraComponent &cameraComponent) const {
     }
 
+    /** Cameras follow the rendered frames, and read per-frame input (e.g. the scroll delta of the editor).
+     */
+    [[nodiscard]] SystemUpdateRate GetUpdateRate() const override {
+        return SystemUpdateRate::EveryFrame;
+    }
+
+    [[nodiscard]] SystemAccess GetAccess() const override {
+        SystemAccess access;
+        access.reads.set(ComponentTypeHelper<LocalTransformComponent>::ID);
+        access.reads.set(ComponentTypeHelper<ParentComponent>::ID);
+        access.reads.set(ComponentTypeHelper<CameraComponent>::ID);
+        access.writes.set(ComponentTypeHelper<CameraComponent>::ID);
+        return access;
+    }
+
     void Update(float dt) override {
         const auto activeCameraId = GetActiveCameraId();
         if (activeCameraId == NULL_ENTITY) {
@@ -85,7 +100,8 @@ public:
             LOG_WARN("Not implemented : CameraSystem does not support ParentComponent on camera entities yet.");
         }
 
-        auto &transform = m_ComponentManager->GetComponent<LocalTransformComponent>(activeCameraId);
+        // Read-only: the transform is not written, and must not be reported as changed to the TransformSystem.
+        const auto &transform = m_ComponentManager->GetComponentReadOnly<LocalTransformComponent>(activeCameraId);
         auto &cameraComponent = m_ComponentManager->GetComponent<CameraComponent>(activeCameraId);
 
         UpdateCamera(cameraComponent);
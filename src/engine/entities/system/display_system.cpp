@@ -1,7 +1,10 @@
 #include "display_system.h"
 
 #include "../../../editor/editor.h"
+#include "../../utils/entities/iteration.h"
 #include "../../utils/macros/log_macros.h"
+#include "../../utils/math_utils.h"
+#include "transform_system.h"
 #include "../components_system/components/camera_component.h"
 #include "../components_system/components/renderable_component.h"
 #include "../components_system/component_manager.h"
@@ -13,7 +16,7 @@ void DisplaySystem::PrepareCamera(const EntityID cameraEntityId) const {
         return;
     }
 
-    const auto &cameraComponent = m_ComponentManager->GetComponent<CameraComponent>(cameraEntityId);
+    const auto &cameraComponent = m_ComponentManager->GetComponentReadOnly<CameraComponent>(cameraEntityId);
 
     m_Renderer->UpdateCameraMatrix(
         cameraComponent.viewMatrix,
@@ -21,24 +24,50 @@ void DisplaySystem::PrepareCamera(const EntityID cameraEntityId) const {
     );
 }
 
-void DisplaySystem::SubmitDrawCalls() const {
-    for (const auto &entity: m_Entities) {
-        const auto &entityTransform = m_ComponentManager->GetComponent<LocalToWorldComponent>(entity);
-        const auto &renderable = m_ComponentManager->GetComponent<RenderableComponent>(entity);
-
-        m_Renderer->SubmitDrawCall(
-            entity,
-            entityTransform.localToWorldMatrix,
-            renderable.meshId,
-            renderable.textureId
-        );
+void DisplaySystem::SubmitDrawCalls(const float interpolationAlpha) const {
+    const bool gpuTransforms = m_TransformSystem && m_TransformSystem->GetMode() == TransformPropagationMode::Gpu;
+    if (gpuTransforms) {
+        m_Renderer->UploadGpuTransforms(m_TransformSystem->GetGpuTransforms());
     }
+
+    Utils::Entities::Iteration::View<const LocalToWorldComponent, const RenderableComponent>(*m_ComponentManager).Each(
+        [this, gpuTransforms, interpolationAlpha](const EntityID entity, const LocalToWorldComponent &entityTransform,
+                              const RenderableComponent &renderable) {
+            uint32_t transformIndex = NO_GPU_TRANSFORM;
+            if (gpuTransforms) {
+                transformIndex = m_TransformSystem->GetGpuTransformIndex(entity);
+                if (transformIndex == NO_GPU_TRANSFORM) {
+                    // Created after the last transform update, its world matrix is not known yet.
+                    return;
+                }
+            }
+
+            // Only entities that moved during the last step are interpolated, GPU transforms draw the last step.
+            glm::mat4 worldMatrix = entityTransform.localToWorldMatrix;
+            if (interpolationAlpha < 1.0f &&
+                entityTransform.previousLocalToWorldMatrix != entityTransform.localToWorldMatrix) {
+                worldMatrix = Utils::Math::InterpolateWorldMatrix(
+                    entityTransform.previousLocalToWorldMatrix,
+                    entityTransform.localToWorldMatrix,
+                    interpolationAlpha
+                );
+            }
+
+            m_Renderer->SubmitDrawCall(
+                entity,
+                worldMatrix,
+                renderable.meshId,
+                renderable.textureId,
+                transformIndex
+            );
+        }
+    );
 }
 
-void DisplaySystem::PrepareForRendering(const EntityID cameraEntityId) const {
+void DisplaySystem::PrepareForRendering(const EntityID cameraEntityId, const float interpolationAlpha) const {
     PrepareCamera(cameraEntityId);
 
     // TODO: Implement lights
 
-    SubmitDrawCalls();
+    SubmitDrawCalls(interpolationAlpha);
 }
@@ -5,28 +5,49 @@
 
 #include "../../renderer/abstract.h"
 
+class TransformSystem;
+
 class DisplaySystem final : public SystemBase {
     std::shared_ptr<AbstractRenderer> m_Renderer;
     std::shared_ptr<EntityManager> m_EntityManager;
+    /** Source of the GPU transforms when the transform system runs in GPU mode.
+     */
+    std::shared_ptr<TransformSystem> m_TransformSystem;
 
 public:
     DisplaySystem(
         const std::shared_ptr<AbstractRenderer> &renderer,
         const std::shared_ptr<ComponentManager> &componentManager,
-        const std::shared_ptr<EntityManager> &entityManager
+        const std::shared_ptr<EntityManager> &entityManager,
+        const std::shared_ptr<TransformSystem> &transformSystem
     ) : SystemBase(componentManager), m_Renderer(renderer),
-        m_EntityManager(entityManager) {
+        m_EntityManager(entityManager), m_TransformSystem(transformSystem) {
     }
 
     void Update(float dt) override {
     };
 
-    void PrepareForRendering(EntityID cameraEntityId) const;
+    /** Drawing happens in PrepareForRendering, outside of the system update.
+     */
+    [[nodiscard]] SystemAccess GetAccess() const override {
+        return {};
+    }
+
+    [[nodiscard]] SystemUpdateRate GetUpdateRate() const override {
+        return SystemUpdateRate::EveryFrame;
+    }
+
+    /** Submits the camera and the draw calls of the frame.
+     *
+     *  @param interpolationAlpha Position of the frame between the previous and the last simulation step
+     *  (see Engine::Update): world matrices are interpolated from their previous value, 1 draws the last step.
+     */
+    void PrepareForRendering(EntityID cameraEntityId, float interpolationAlpha) const;
 
 private:
     void PrepareCamera(EntityID cameraEntityId) const;
 
-    void SubmitDrawCalls() const;
+    void SubmitDrawCalls(float interpolationAlpha) const;
 };
 
 
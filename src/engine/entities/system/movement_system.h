@@ -3,6 +3,7 @@
 
 #include "system.h"
 #include "../../logging/logger.h"
+#include "../../utils/entities/iteration.h"
 #include "../components_system/component_manager.h"
 #include "../components_system/components/local_transform_component.h"
 #include "../components_system/components/velocity_component.h"
@@ -11,26 +12,35 @@
 struct VelocityComponent;
 
 class MovementSystem final : public SystemBase {
-public:
-    using SystemBase::SystemBase;
+    using Query = Utils::Entities::Iteration::View<LocalTransformComponent, const VelocityComponent>;
 
-    void Update(const float dt) override {
-        for (const auto entity: m_Entities) {
-            auto &transform = m_ComponentManager->GetComponent<LocalTransformComponent>(entity);
-            const auto &velocity = m_ComponentManager->GetComponent<VelocityComponent>(entity);
+    static void Integrate(LocalTransformComponent &transform, const VelocityComponent &velocity, const float dt) {
+        transform.position += velocity.linearVelocity * dt;
+
+        const float angularRate = glm::length(velocity.angularVelocity);
+
+        if (angularRate > 0.0001f) {
+            float angle = angularRate * dt;
+            glm::vec3 axis = velocity.angularVelocity / angularRate;
+            glm::quat deltaRotation = glm::angleAxis(angle, axis);
+            transform.rotation = transform.rotation * deltaRotation;
+            transform.rotation = glm::normalize(transform.rotation);
+        }
+    }
 
-            transform.position += velocity.linearVelocity * dt;
+public:
+    using SystemBase::SystemBase;
 
-            const float angularRate = glm::length(velocity.angularVelocity);
+    [[nodiscard]] SystemAccess GetAccess() const override {
+        return {Query::GetReadSignature(), Query::GetWriteSignature()};
+    }
 
-            if (angularRate > 0.0001f) {
-                float angle = angularRate * dt;
-                glm::vec3 axis = velocity.angularVelocity / angularRate;
-                glm::quat deltaRotation = glm::angleAxis(angle, axis);
-                transform.rotation = transform.rotation * deltaRotation;
-                transform.rotation = glm::normalize(transform.rotation);
+    void Update(const float dt) override {
+        Query(*m_ComponentManager).Each(
+            [dt](LocalTransformComponent &transform, const VelocityComponent &velocity) {
+                Integrate(transform, velocity, dt);
             }
-        }
+        );
     }
 };
 
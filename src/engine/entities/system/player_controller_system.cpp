@@ -4,17 +4,22 @@
 #include "../components_system/components/velocity_component.h"
 #include "../../io/input_system.h"
 #include "../components_system/component_manager.h"
+#include "../../utils/entities/iteration.h"
 
 PlayerControllerSystem::PlayerControllerSystem(
     const std::shared_ptr<ComponentManager> &componentManager
 ) : SystemBase(componentManager) {
 }
 
-void PlayerControllerSystem::Update(float dt) {
-    for (const auto &entity: m_Entities) {
-        auto &velocity = m_ComponentManager->GetComponent<VelocityComponent>(entity);
-        const auto &playerController = m_ComponentManager->GetComponent<PlayerControllerComponent>(entity);
+SystemAccess PlayerControllerSystem::GetAccess() const {
+    return {Query::GetReadSignature(), Query::GetWriteSignature()};
+}
 
+void PlayerControllerSystem::Update(float dt) {
+    Query(*m_ComponentManager).Each([](
+        VelocityComponent &velocity,
+        const PlayerControllerComponent &playerController
+    ) {
         glm::vec3 direction(0.0f);
 
         if (InputSystem::IsKeyPressed(playerController.moveForwardKey)) {
@@ -35,5 +40,5 @@ void PlayerControllerSystem::Update(float dt) {
         }
 
         velocity.linearVelocity = direction * playerController.movementSpeed;
-    }
+    });
 }
@@ -1,11 +1,18 @@
 #ifndef VEE_PLAYER_CONTROLLER_SYSTEM_H
 #define VEE_PLAYER_CONTROLLER_SYSTEM_H
 #include "system.h"
+#include "../../utils/entities/iteration.h"
+#include "../components_system/components/player_controller_component.h"
+#include "../components_system/components/velocity_component.h"
 
 class PlayerControllerSystem final : public SystemBase {
+    using Query = Utils::Entities::Iteration::View<VelocityComponent, const PlayerControllerComponent>;
+
 public:
     explicit PlayerControllerSystem(const std::shared_ptr<ComponentManager> &componentManager);
 
+    [[nodiscard]] SystemAccess GetAccess() const override;
+
     void Update(float dt) override;;
 };
 
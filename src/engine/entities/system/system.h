@@ -1,12 +1,52 @@
 #ifndef GAME_ENGINE_BASE_H
 #define GAME_ENGINE_BASE_H
-#include <set>
-
 #include "../manager.h"
+#include "../sparse_set.h"
 
 class ComponentManager;
 
+namespace Utils::Threading {
+    class ThreadPool;
+}
+
+/** Component types a system reads and writes during Update, used to schedule systems concurrently.
+ *
+ * Two systems conflict (and run in registration order) when one writes a component the other reads or
+ * writes, or when either is exclusive. Typed views provide matching signatures, e.g.
+ * `View<LocalTransformComponent, const VelocityComponent>::GetReadSignature()`.
+ */
+struct SystemAccess {
+    Signature reads;
+    Signature writes;
+    /** Exclusive systems never run concurrently with any other system.
+     */
+    bool exclusive = false;
+
+    [[nodiscard]] bool ConflictsWith(const SystemAccess &other) const {
+        return exclusive || other.exclusive
+               || (writes & (other.reads | other.writes)).any()
+               || (other.writes & reads).any();
+    }
+};
+
+/** When a system runs in a frame, see Engine::Update.
+ */
+enum class SystemUpdateRate {
+    /** Simulation: zero or more times per frame, with a fixed time step.
+     */
+    FixedStep,
+    /** Once per rendered frame, with the frame time (e.g. cameras and other per-frame input).
+     */
+    EveryFrame
+};
+
 class SystemBase {
+    ChangeVersion m_LastUpdateVersion = 0;
+    uint64_t m_MembershipVersion = 0;
+    Utils::Threading::ThreadPool *m_ThreadPool = nullptr;
+
+    friend class SystemManager;
+
 protected:
     std::shared_ptr<ComponentManager> m_ComponentManager;
 
@@ -17,10 +57,48 @@ public:
         : m_ComponentManager(componentManager) {
     }
 
-    std::set<EntityID> m_Entities;
+    /** Entities matching the system signature, maintained by the SystemManager.
+     *  Packed in insertion order, which follows the order in which components were added.
+     */
+    SparseSet m_Entities;
 
     virtual void Update(float dt) = 0;
 
+    /** Change version of the frame in which the system was last updated (0 before its first update).
+     *  Components written after that update have a version at or after this one, so it can be passed to
+     *  View::ChangedSince to only process what changed since the previous run.
+     */
+    [[nodiscard]] ChangeVersion GetLastUpdateVersion() const {
+        return m_LastUpdateVersion;
+    }
+
+    /** Incremented by the SystemManager every time m_Entities changes, so that data derived from the
+     *  membership can tell when to rebuild.
+     */
+    [[nodiscard]] uint64_t GetMembershipVersion() const {
+        return m_MembershipVersion;
+    }
+
+    /** Pool of the current update, on which Update can split its own work (submitting tasks and waiting
+     *  with RunUntil, which also works from a worker). Null when the pool has no workers or no pool was given.
+     */
+    [[nodiscard]] Utils::Threading::ThreadPool *GetThreadPool() const {
+        return m_ThreadPool;
+    }
+
+    /** Declares the components accessed by Update.
+     *  Defaults to exclusive access, which is always safe; override it to let the system run in parallel.
+     */
+    [[nodiscard]] virtual SystemAccess GetAccess() const {
+        SystemAccess access;
+        access.exclusive = true;
+        return access;
+    }
+
+    [[nodiscard]] virtual SystemUpdateRate GetUpdateRate() const {
+        return SystemUpdateRate::FixedStep;
+    }
+
     virtual ~SystemBase() = default;
 };
 
@@ -1,11 +1,19 @@
 #ifndef GAME_ENGINE_SYSTEM_MANAGER_H
 #define GAME_ENGINE_SYSTEM_MANAGER_H
+#include <array>
+#include <atomic>
+#include <exception>
+#include <functional>
 #include <map>
+#include <mutex>
+#include <optional>
 #include <ranges>
 #include <typeindex>
+#include <vector>
 
 #include "../manager.h"
 #include "system.h"
+#include "../../utils/threading/thread_pool.h"
 
 class ComponentManager;
 
@@ -13,11 +21,162 @@ class SystemManager {
     std::map<std::type_index, Signature> m_Signatures;
     std::map<std::type_index, std::shared_ptr<SystemBase> > m_Systems;
 
+    /** Node of the system dependency graph.
+     */
+    struct ScheduledSystem {
+        std::shared_ptr<SystemBase> system;
+        /** Systems registered later that conflict with this one and must wait for it.
+         */
+        std::vector<size_t> successors;
+        size_t predecessorCount = 0;
+        SystemUpdateRate updateRate = SystemUpdateRate::FixedStep;
+    };
+
+    /** Systems in registration order, which is also the order conflicting systems run in.
+     */
+    std::vector<std::type_index> m_RegistrationOrder;
+    std::vector<ScheduledSystem> m_Schedule;
+    std::unique_ptr<std::atomic<size_t>[]> m_PendingPredecessors;
+    bool m_ScheduleDirty = true;
+
+    /** For each component type, the systems whose signature contains it.
+     */
+    std::array<std::vector<std::pair<SystemBase *, Signature> >, COMPONENTS_COUNT> m_SystemsByComponent;
+    /** Systems with an empty signature, which match every entity.
+     */
+    std::vector<SystemBase *> m_UnfilteredSystems;
+
+    /** Rebuilds the component -> systems dispatch table.
+     */
+    void RebuildDispatchTable() {
+        for (auto &systems: m_SystemsByComponent) {
+            systems.clear();
+        }
+        m_UnfilteredSystems.clear();
+
+        for (const auto &[typeId, system]: m_Systems) {
+            const auto it = m_Signatures.find(typeId);
+            const Signature signature = it != m_Signatures.end() ? it->second : Signature{};
+
+            if (signature.none()) {
+                m_UnfilteredSystems.push_back(system.get());
+                continue;
+            }
+            for (size_t componentType = 0; componentType < COMPONENTS_COUNT; ++componentType) {
+                if (signature.test(componentType)) {
+                    m_SystemsByComponent[componentType].emplace_back(system.get(), signature);
+                }
+            }
+        }
+    }
+
+    /** Adds or removes the entity from the system so that membership reflects the signature match.
+     *  Idempotent, so a system reached through several changed components is handled correctly.
+     */
+    static void UpdateMembership(SystemBase &system, const EntityID entity, const bool matches) {
+        const bool contains = system.m_Entities.Contains(entity);
+        if (matches && !contains) {
+            system.m_Entities.Insert(entity);
+            ++system.m_MembershipVersion;
+        } else if (!matches && contains) {
+            system.m_Entities.Remove(entity);
+            ++system.m_MembershipVersion;
+        }
+    }
+
+    /** Builds the dependency graph: each system depends on every earlier registered system it conflicts with.
+     */
+    void RebuildSchedule() {
+        m_Schedule.clear();
+        std::vector<SystemAccess> accesses;
+        for (const auto &typeId: m_RegistrationOrder) {
+            const auto &system = m_Systems.at(typeId);
+            accesses.push_back(system->GetAccess());
+            m_Schedule.push_back({system, {}, 0, system->GetUpdateRate()});
+        }
+
+        for (size_t later = 0; later < m_Schedule.size(); ++later) {
+            for (size_t earlier = 0; earlier < later; ++earlier) {
+                if (accesses[earlier].ConflictsWith(accesses[later])) {
+                    m_Schedule[earlier].successors.push_back(later);
+                    ++m_Schedule[later].predecessorCount;
+                }
+            }
+        }
+
+        m_PendingPredecessors = std::make_unique<std::atomic<size_t>[]>(m_Schedule.size());
+        m_ScheduleDirty = false;
+    }
+
+    /** Updates a scheduled system, unless the update is restricted to another update rate.
+     */
+    void RunScheduled(
+        const ScheduledSystem &scheduled,
+        const float deltaTime,
+        const ChangeVersion changeVersion,
+        const std::optional<SystemUpdateRate> rate
+    ) const {
+        if (rate.has_value() && scheduled.updateRate != *rate) {
+            return;
+        }
+        scheduled.system->Update(deltaTime);
+        scheduled.system->m_LastUpdateVersion = changeVersion;
+    }
+
+    void RunScheduleInParallel(
+        const float deltaTime,
+        const ChangeVersion changeVersion,
+        const std::optional<SystemUpdateRate> rate,
+        Utils::Threading::ThreadPool &threadPool
+    ) {
+        std::atomic<size_t> remaining = m_Schedule.size();
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        std::function<void(size_t)> runSystem = [&](const size_t index) {
+            try {
+                RunScheduled(m_Schedule[index], deltaTime, changeVersion, rate);
+            } catch (...) {
+                std::lock_guard lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+
+            for (const size_t successor: m_Schedule[index].successors) {
+                if (m_PendingPredecessors[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    threadPool.Submit([&runSystem, successor] { runSystem(successor); });
+                }
+            }
+            remaining.fetch_sub(1, std::memory_order_acq_rel);
+        };
+
+        for (size_t i = 0; i < m_Schedule.size(); ++i) {
+            m_PendingPredecessors[i].store(m_Schedule[i].predecessorCount, std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < m_Schedule.size(); ++i) {
+            if (m_Schedule[i].predecessorCount == 0) {
+                threadPool.Submit([&runSystem, i] { runSystem(i); });
+            }
+        }
+
+        threadPool.RunUntil([&remaining] { return remaining.load(std::memory_order_acquire) == 0; });
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
 public:
     template<typename T>
     std::shared_ptr<T> RegisterSystem(const std::shared_ptr<T> &system) {
         const std::type_index typeId = typeid(T);
+        if (!m_Systems.contains(typeId)) {
+            m_RegistrationOrder.push_back(typeId);
+        }
         m_Systems[typeId] = system;
+        m_ScheduleDirty = true;
+        RebuildDispatchTable();
         return system;
     }
 
@@ -25,39 +184,114 @@ public:
     void SetSignature(const Signature signature) {
         const std::type_index typeId = typeid(T);
         m_Signatures[typeId] = signature;
+        RebuildDispatchTable();
     }
 
+    /** Updates system memberships after the signature of an entity changed.
+     *  Only the systems whose signature contains one of the changed component types are visited.
+     */
     void EntitySignatureChanged(
         const EntityID entity,
+        const Signature previousSignature,
         const Signature entitySignature
     ) {
-        for (const auto &pair: m_Systems) {
-            const std::type_index &typeId = pair.first;
-            auto &system = pair.second;
-
-            const Signature &systemSignature = m_Signatures[typeId];
-
-            // Check if the entity's signature *matches* the system's required signature
-            if ((entitySignature & systemSignature) == systemSignature) {
-                // Entity is now relevant: Add to the system
-                system->m_Entities.insert(entity);
-            } else {
-                // Entity is no longer relevant: Remove from the system
-                system->m_Entities.erase(entity);
+        const Signature changed = previousSignature ^ entitySignature;
+        for (size_t componentType = 0; componentType < COMPONENTS_COUNT; ++componentType) {
+            if (!changed.test(componentType)) {
+                continue;
+            }
+            for (const auto &[system, systemSignature]: m_SystemsByComponent[componentType]) {
+                UpdateMembership(*system, entity, (entitySignature & systemSignature) == systemSignature);
+            }
+        }
+
+        for (const auto system: m_UnfilteredSystems) {
+            UpdateMembership(*system, entity, true);
+        }
+    }
+
+    /** Registers freshly created entities sharing the same signature with every interested system, in one pass.
+     *  The entities must not belong to any system yet.
+     */
+    void EntitiesCreated(const std::vector<EntityID> &entities, const Signature &signature) {
+        for (const auto &[typeId, system]: m_Systems) {
+            const auto it = m_Signatures.find(typeId);
+            const Signature systemSignature = it != m_Signatures.end() ? it->second : Signature{};
+            if ((signature & systemSignature) != systemSignature) {
+                continue;
+            }
+
+            system->m_Entities.Reserve(system->m_Entities.Size() + entities.size());
+            for (const auto entity: entities) {
+                system->m_Entities.Insert(entity);
+            }
+            ++system->m_MembershipVersion;
+        }
+    }
+
+    /** Updates every system.
+     *
+     *  Systems whose declared accesses conflict run in registration order; the others may run concurrently
+     *  on the given thread pool. Without a pool (or with a pool without workers), systems run one after the
+     *  other in registration order. Either way, systems can split their own work on the pool (see
+     *  SystemBase::GetThreadPool).
+     *
+     *  @param changeVersion Current change version of the component manager (see
+     *  ComponentManager::AdvanceChangeVersion), recorded as the last update version of each system.
+     *  @param rate Only updates the systems with this update rate (see SystemBase::GetUpdateRate), or every
+     *  system when empty. Skipped systems keep their last update version.
+     */
+    void UpdateSystems(
+        const float deltaTime,
+        const ChangeVersion changeVersion,
+        Utils::Threading::ThreadPool *threadPool = nullptr,
+        const std::optional<SystemUpdateRate> rate = std::nullopt
+    ) {
+        if (m_ScheduleDirty) {
+            RebuildSchedule();
+        }
+
+        if (threadPool != nullptr && threadPool->GetWorkerCount() == 0) {
+            threadPool = nullptr;
+        }
+        for (const auto &scheduled: m_Schedule) {
+            scheduled.system->m_ThreadPool = threadPool;
+        }
+
+        if (threadPool == nullptr || m_Schedule.size() < 2) {
+            for (const auto &scheduled: m_Schedule) {
+                RunScheduled(scheduled, deltaTime, changeVersion, rate);
             }
+            return;
         }
+
+        RunScheduleInParallel(deltaTime, changeVersion, rate, *threadPool);
     }
 
-    void UpdateSystems(const float deltaTime) {
-        for (const auto &val: m_Systems | std::views::values) {
-            auto &system = val;
-            system->Update(deltaTime);
+    /** Returns the systems in execution order (registration order).
+     */
+    [[nodiscard]] std::vector<std::shared_ptr<SystemBase> > GetExecutionOrder() const {
+        std::vector<std::shared_ptr<SystemBase> > systems;
+        for (const auto &typeId: m_RegistrationOrder) {
+            systems.push_back(m_Systems.at(typeId));
         }
+        return systems;
     }
 
     void RemoveEntity(const EntityID entity) {
-        return EntitySignatureChanged(entity, 0);
+        for (const auto &system: m_Systems | std::views::values) {
+            UpdateMembership(*system, entity, false);
+        }
     };
+
+    /** Empties the entity set of every system, e.g. before the whole world is replaced.
+     */
+    void ClearEntities() {
+        for (const auto &system: m_Systems | std::views::values) {
+            system->m_Entities.Clear();
+            ++system->m_MembershipVersion;
+        }
+    }
 };
 
 
@@ -1,8 +1,16 @@
 #ifndef VEE_TRANSFORM_SYSTEM_H
 #define VEE_TRANSFORM_SYSTEM_H
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 #include "system.h"
+#include "../../renderer/gpu_transforms.h"
 #include "../../utils/math_utils.h"
-#include "../../utils/macros/log_macros.h"
+#include "../../utils/entities/iteration.h"
+#include "../../utils/threading/thread_pool.h"
 
 #include "../components_system/component_manager.h"
 #include "../components_system/components/local_to_world_component.h"
@@ -10,61 +18,630 @@
 #include "../components_system/components/parent_component.h"
 
 
+/** How TransformSystem distributes its work, see TransformSystem.
+ */
+enum class TransformPropagationMode {
+    Serial,
+    Parallel,
+    Gpu
+};
+
+/** Computes the world matrix of every entity from its local transform and the world matrix of its parent.
+ *
+ * Entities are processed in the flattened order of the hierarchy (see FlatHierarchy), where parents come
+ * before their children, so each world matrix is computed once, from the cached result of the parent.
+ * Entities without a LocalTransformComponent act as identity transforms (simple groups), and world matrices
+ * are cached per position for every entity, so they can be used as parents even without a LocalToWorldComponent.
+ *
+ * Only dirty subtrees are recomputed. An entity is dirty when its LocalTransformComponent was written since
+ * the previous update, and the flag propagates to its whole subtree, while clean branches are skipped. When the
+ * hierarchy order is rebuilt (reparenting, entities created or destroyed) or the system membership changes, the
+ * cached matrices follow their entities to their new positions, and only new or reparented entities, and
+ * entities that gained or lost a transform component, are dirty (see RemapCache).
+ *
+ * In parallel mode, large updates are split across the workers of the system thread pool (see GetThreadPool).
+ * Independent subtrees are spread over tasks, and big trees are processed one depth level at a time: entities
+ * of a level only depend on the level above, so each level is split across the workers. Updates of fewer than
+ * PARALLEL_MIN_ENTITIES entities, or without a pool, stay serial.
+ *
+ * In GPU mode, nothing is computed on the CPU: local transforms are gathered in depth-level order (see
+ * GetGpuTransforms) and the renderer propagates them with a compute shader, its vertex shader reading the world
+ * matrices directly. LocalToWorldComponents are not written in this mode.
+ */
 class TransformSystem final : public SystemBase {
+    using ChangedTransforms = Utils::Entities::Iteration::View<const LocalTransformComponent>;
+
 public:
-    using SystemBase::SystemBase;
+    /** Smallest update (in entities) worth splitting across threads in parallel mode.
+     */
+    static constexpr uint32_t PARALLEL_MIN_ENTITIES = 16384;
+    /** Smallest share of a depth level given to one task.
+     */
+    static constexpr uint32_t PARALLEL_MIN_TASK_SIZE = 2048;
 
-    /** Recursively computes the world transform matrix for the given entity,
-     * taking into account its local transform and the transforms of its parent entities.
-     *
-     * TODO: This function currently does not take advantage of the cached matrices.
-     *
-     * @param entity The ID of the entity for which to compute the world transform matrix.
-     * @return The computed world transform matrix as a `glm::mat4`.
+private:
+    /** Positions are processed in batches: local transforms are gathered into structure of arrays, composed
+     *  and multiplied by their parent matrices with the batched kernels of Utils::Math.
+     */
+    static constexpr uint32_t BATCH_SIZE = 256;
+
+    struct Batch {
+        Utils::Math::TransformArrays transforms;
+        std::vector<glm::mat4> localMatrices;
+        std::vector<glm::mat4> worldMatrices;
+        std::vector<const glm::mat4 *> parents;
+
+        Batch() {
+            transforms.Resize(BATCH_SIZE);
+            localMatrices.resize(BATCH_SIZE);
+            worldMatrices.resize(BATCH_SIZE);
+            parents.resize(BATCH_SIZE);
+        }
+    };
+
+    TransformPropagationMode m_Mode = TransformPropagationMode::Parallel;
+
+    /** Hierarchy order and membership the cached matrices were computed for. Order versions start at 1.
+     */
+    uint64_t m_OrderVersion = 0;
+    uint64_t m_MembershipVersion = 0;
+
+    /** World matrix of each position of the hierarchy order.
+     */
+    std::vector<glm::mat4> m_WorldMatrices;
+    /** Entity, parent and transform components (TransformFlags) of each position of the order the cached
+     *  matrices were computed for, to recognize them in the next order.
+     */
+    std::vector<EntityID> m_CachedEntities;
+    std::vector<EntityID> m_CachedParents;
+    std::vector<uint8_t> m_CachedFlags;
+    /** RemapCache: new order being built, and previous position of each entity index (NO_POSITION otherwise).
+     */
+    std::vector<glm::mat4> m_RemappedMatrices;
+    std::vector<EntityID> m_RemappedParents;
+    std::vector<uint8_t> m_RemappedFlags;
+    std::vector<uint32_t> m_PreviousPositions;
+    std::vector<uint32_t> m_DirtyPositions;
+    /** Position ranges [first, second) recomputed by the current update.
+     */
+    std::vector<std::pair<uint32_t, uint32_t> > m_DirtyRanges;
+    /** Ranges written by the previous update, whose previous matrices are settled by the next one.
      */
-    glm::mat4 ComputeAndCacheTransformMatrix(const EntityID entity) {
-        LocalTransformComponent localTransform;
-        // Get the local transform; if it doesn't exist, use default values to handle simple groups definitions
-        // (without local transform).
+    std::vector<std::pair<uint32_t, uint32_t> > m_SettlingRanges;
+
+    /** Parallel mode: positions of the current update grouped by depth, level `d` being
+     *  [m_LevelOffsets[d], m_LevelOffsets[d + 1]) of m_LevelPositions.
+     */
+    std::vector<uint32_t> m_LevelOffsets;
+    std::vector<uint32_t> m_LevelPositions;
+    std::vector<uint32_t> m_LevelCursors;
+    /** Parallel mode: subtrees split by depth level, and ranges computed by each task, task `t` being
+     *  [m_TaskOffsets[t], m_TaskOffsets[t + 1]) of m_TaskRanges.
+     */
+    std::vector<std::pair<uint32_t, uint32_t> > m_LargeRanges;
+    std::vector<std::pair<uint32_t, uint32_t> > m_TaskRanges;
+    std::vector<size_t> m_TaskOffsets;
+
+    /** GPU mode: uploaded transforms, the entity of each of them, and the index of each entity in them
+     *  (by entity index). Rebuilt with the hierarchy order, since parents are referenced by index.
+     */
+    GpuTransformData m_GpuTransforms;
+    std::vector<EntityID> m_GpuEntities;
+    std::vector<uint32_t> m_GpuIndices;
+
+    /** One batch for serial updates, then one per concurrent task of a level.
+     */
+    std::vector<Batch> m_Batches = std::vector<Batch>(1);
+
+    /** Stores the local transform of an entity at `index` of the batch (identity when it has none).
+     */
+    void GatherLocalTransform(const EntityID entity, const uint32_t index, Batch &batch) const {
         if (m_ComponentManager->HasComponent<LocalTransformComponent>(entity)) {
-            localTransform = m_ComponentManager->GetComponent<LocalTransformComponent>(entity);
+            const auto &localTransform = m_ComponentManager->GetComponentReadOnly<LocalTransformComponent>(entity);
+            batch.transforms.Set(index, localTransform.position, localTransform.rotation, localTransform.scale);
         } else {
-            localTransform.position = glm::vec3(0.0f, 0.0f, 0.0f);
-            localTransform.rotation = glm::quat(1, 0, 0, 0);
-            localTransform.scale = glm::vec3(1.0f, 1.0f, 1.0f);
+            batch.transforms.SetIdentity(index);
+        }
+    }
+
+    /** Recomputes the cached world matrices of the positions [begin, end) of the hierarchy order.
+     *  Parents outside of the range must have up-to-date cached matrices.
+     */
+    void ComputeRange(const FlatHierarchy &hierarchy, const uint32_t begin, const uint32_t end, Batch &batch) {
+        const auto &entities = hierarchy.GetEntities();
+        const auto &parentPositions = hierarchy.GetParentPositions();
+
+        for (uint32_t batchBegin = begin; batchBegin < end; batchBegin += BATCH_SIZE) {
+            const uint32_t batchCount = std::min(BATCH_SIZE, end - batchBegin);
+            for (uint32_t i = 0; i < batchCount; ++i) {
+                const uint32_t position = batchBegin + i;
+                GatherLocalTransform(entities[position], i, batch);
+
+                const uint32_t parentPosition = parentPositions[position];
+                batch.parents[i] = parentPosition != FlatHierarchy::NO_PARENT
+                                       ? &m_WorldMatrices[parentPosition]
+                                       : nullptr;
+            }
+
+            // Parents come before their children, so they are either cached or earlier in the batch.
+            Utils::Math::ComposeWorldMatrices(batch.transforms, 0, batchCount, batch.localMatrices.data());
+            Utils::Math::MultiplyWorldMatrices(
+                batchCount, batch.parents.data(), batch.localMatrices.data(), m_WorldMatrices.data() + batchBegin
+            );
+        }
+    }
+
+    /** Recomputes the cached world matrices of the given positions, which must not depend on each other
+     *  (e.g. positions of the same depth level).
+     */
+    void ComputePositions(
+        const FlatHierarchy &hierarchy,
+        const uint32_t *positions,
+        const uint32_t count,
+        Batch &batch
+    ) {
+        const auto &entities = hierarchy.GetEntities();
+        const auto &parentPositions = hierarchy.GetParentPositions();
+
+        for (uint32_t batchBegin = 0; batchBegin < count; batchBegin += BATCH_SIZE) {
+            const uint32_t batchCount = std::min(BATCH_SIZE, count - batchBegin);
+            const uint32_t *batchPositions = positions + batchBegin;
+            for (uint32_t i = 0; i < batchCount; ++i) {
+                GatherLocalTransform(entities[batchPositions[i]], i, batch);
+
+                const uint32_t parentPosition = parentPositions[batchPositions[i]];
+                batch.parents[i] = parentPosition != FlatHierarchy::NO_PARENT
+                                       ? &m_WorldMatrices[parentPosition]
+                                       : nullptr;
+            }
+
+            Utils::Math::ComposeWorldMatrices(batch.transforms, 0, batchCount, batch.localMatrices.data());
+            Utils::Math::MultiplyWorldMatrices(
+                batchCount, batch.parents.data(), batch.localMatrices.data(), batch.worldMatrices.data()
+            );
+            for (uint32_t i = 0; i < batchCount; ++i) {
+                m_WorldMatrices[batchPositions[i]] = batch.worldMatrices[i];
+            }
+        }
+    }
+
+    /** Runs `func(task)` for every task in [0, taskCount) on the pool and waits for all of them.
+     */
+    template<typename Func>
+    static void RunTasks(Utils::Threading::ThreadPool &threadPool, const size_t taskCount, const Func &func) {
+        std::atomic<size_t> remaining = taskCount;
+        for (size_t task = 0; task < taskCount; ++task) {
+            threadPool.Submit([&func, &remaining, task] {
+                func(task);
+                remaining.fetch_sub(1, std::memory_order_acq_rel);
+            });
+        }
+        threadPool.RunUntil([&remaining] { return remaining.load(std::memory_order_acquire) == 0; });
+    }
+
+    /** Groups the positions of the given ranges by depth into m_LevelOffsets / m_LevelPositions.
+     */
+    void SortByLevel(const FlatHierarchy &hierarchy, const std::vector<std::pair<uint32_t, uint32_t> > &ranges) {
+        const auto &depths = hierarchy.GetDepths();
+
+        // Counting sort of the positions by depth, keeping the hierarchy order within a level.
+        m_LevelOffsets.assign(hierarchy.GetMaxDepth() + 2, 0);
+        for (const auto &[begin, end]: ranges) {
+            for (uint32_t position = begin; position < end; ++position) {
+                ++m_LevelOffsets[depths[position] + 1];
+            }
+        }
+        for (size_t level = 1; level < m_LevelOffsets.size(); ++level) {
+            m_LevelOffsets[level] += m_LevelOffsets[level - 1];
+        }
+        m_LevelPositions.resize(m_LevelOffsets.back());
+        m_LevelCursors.assign(m_LevelOffsets.begin(), m_LevelOffsets.end() - 1);
+        for (const auto &[begin, end]: ranges) {
+            for (uint32_t position = begin; position < end; ++position) {
+                m_LevelPositions[m_LevelCursors[depths[position]]++] = position;
+            }
+        }
+    }
+
+    /** Recomputes the given ranges level by level, splitting each level across the workers of the pool.
+     */
+    void ComputeLevelsInParallel(
+        const FlatHierarchy &hierarchy,
+        const std::vector<std::pair<uint32_t, uint32_t> > &ranges,
+        Utils::Threading::ThreadPool &threadPool
+    ) {
+        SortByLevel(hierarchy, ranges);
+
+        for (size_t level = 0; level + 1 < m_LevelOffsets.size(); ++level) {
+            const uint32_t *levelPositions = m_LevelPositions.data() + m_LevelOffsets[level];
+            const uint32_t levelCount = m_LevelOffsets[level + 1] - m_LevelOffsets[level];
+            const size_t taskCount = std::min<size_t>(
+                m_Batches.size(), (levelCount + PARALLEL_MIN_TASK_SIZE - 1) / PARALLEL_MIN_TASK_SIZE
+            );
+            if (taskCount <= 1) {
+                ComputePositions(hierarchy, levelPositions, levelCount, m_Batches[0]);
+                continue;
+            }
+
+            // Levels run one after the other: the parents of a level are computed by the previous one.
+            RunTasks(threadPool, taskCount, [&](const size_t task) {
+                const auto taskBegin = static_cast<uint32_t>(levelCount * task / taskCount);
+                const auto taskEnd = static_cast<uint32_t>(levelCount * (task + 1) / taskCount);
+                ComputePositions(hierarchy, levelPositions + taskBegin, taskEnd - taskBegin, m_Batches[task]);
+            });
+        }
+    }
+
+    /** Recomputes the dirty ranges on the pool.
+     *
+     *  Dirty ranges are made of whole subtrees, which do not depend on each other: subtrees up to a fair share
+     *  of the work are grouped into tasks and computed in hierarchy order. Bigger subtrees are then split by
+     *  depth level with ComputeLevelsInParallel.
+     */
+    void ComputeInParallel(
+        const FlatHierarchy &hierarchy,
+        const size_t dirtyCount,
+        Utils::Threading::ThreadPool &threadPool
+    ) {
+        const auto &subtreeSizes = hierarchy.GetSubtreeSizes();
+        const size_t maxTasks = threadPool.GetWorkerCount() + 1;
+        if (m_Batches.size() < maxTasks) {
+            m_Batches.resize(maxTasks);
+        }
+        const size_t share = std::max<size_t>(PARALLEL_MIN_TASK_SIZE, (dirtyCount + maxTasks - 1) / maxTasks);
+
+        m_LargeRanges.clear();
+        m_TaskRanges.clear();
+        m_TaskOffsets.assign(1, 0);
+        size_t taskSize = 0;
+        for (const auto &[begin, end]: m_DirtyRanges) {
+            uint32_t runBegin = begin;
+            for (uint32_t root = begin; root < end;) {
+                const uint32_t rootEnd = root + subtreeSizes[root];
+                if (rootEnd - root > share) {
+                    if (runBegin < root) {
+                        m_TaskRanges.emplace_back(runBegin, root);
+                        taskSize += root - runBegin;
+                    }
+                    m_LargeRanges.emplace_back(root, rootEnd);
+                    runBegin = rootEnd;
+                } else if (taskSize + (rootEnd - runBegin) >= share) {
+                    m_TaskRanges.emplace_back(runBegin, rootEnd);
+                    m_TaskOffsets.push_back(m_TaskRanges.size());
+                    taskSize = 0;
+                    runBegin = rootEnd;
+                }
+                root = rootEnd;
+            }
+            if (runBegin < end) {
+                m_TaskRanges.emplace_back(runBegin, end);
+                taskSize += end - runBegin;
+            }
+        }
+        if (m_TaskOffsets.back() != m_TaskRanges.size()) {
+            m_TaskOffsets.push_back(m_TaskRanges.size());
+        }
+
+        const size_t taskCount = m_TaskOffsets.size() - 1;
+        for (size_t first = 0; first < taskCount; first += maxTasks) {
+            RunTasks(threadPool, std::min(maxTasks, taskCount - first), [&](const size_t task) {
+                for (size_t range = m_TaskOffsets[first + task]; range < m_TaskOffsets[first + task + 1]; ++range) {
+                    const auto &[begin, end] = m_TaskRanges[range];
+                    ComputeRange(hierarchy, begin, end, m_Batches[task]);
+                }
+            });
+        }
+
+        if (!m_LargeRanges.empty()) {
+            ComputeLevelsInParallel(hierarchy, m_LargeRanges, threadPool);
         }
-        auto &localToWorld = m_ComponentManager->GetComponent<LocalToWorldComponent>(entity);
+    }
+
+    /** Copies the cached world matrices of the positions [begin, end) to the LocalToWorldComponents, keeping
+     *  the matrices they replace as previous matrices (a new entity has no previous step to come from).
+     *  Serial: writing components marks them (or their chunk) as changed, which is not thread-safe.
+     */
+    void WriteRange(const FlatHierarchy &hierarchy, const uint32_t begin, const uint32_t end) const {
+        const auto &entities = hierarchy.GetEntities();
+        for (uint32_t position = begin; position < end; ++position) {
+            const EntityID entity = entities[position];
+            if (m_ComponentManager->HasComponent<LocalToWorldComponent>(entity)) {
+                auto &localToWorld = m_ComponentManager->GetComponent<LocalToWorldComponent>(entity);
+                localToWorld.previousLocalToWorldMatrix =
+                        localToWorld.isDirty ? m_WorldMatrices[position] : localToWorld.localToWorldMatrix;
+                localToWorld.localToWorldMatrix = m_WorldMatrices[position];
+                localToWorld.isDirty = false;
+            }
+        }
+    }
+
+    /** Entities written by the previous update and left alone by this one stopped moving: their previous
+     *  matrix catches up with the current one, so rendering stops interpolating them. Positions are the ones
+     *  of the cached order, the entities may since have moved or been destroyed.
+     */
+    void SettleRange(const uint32_t begin, const uint32_t end) const {
+        for (uint32_t position = begin; position < end; ++position) {
+            const EntityID entity = m_CachedEntities[position];
+            if (m_ComponentManager->HasComponent<LocalToWorldComponent>(entity)) {
+                auto &localToWorld = m_ComponentManager->GetComponent<LocalToWorldComponent>(entity);
+                localToWorld.previousLocalToWorldMatrix = localToWorld.localToWorldMatrix;
+            }
+        }
+    }
 
-        // If the local to world matrix is not dirty, return the cached matrix.
-        if (!localToWorld.isDirty) {
-            return localToWorld.localToWorldMatrix;
+    static constexpr uint8_t HAS_LOCAL_TRANSFORM = 1;
+    static constexpr uint8_t HAS_LOCAL_TO_WORLD = 2;
+
+    /** Transform components of the entity: those deciding its world matrix (identity without a local
+     *  transform), and whether it is written to a LocalToWorldComponent.
+     */
+    [[nodiscard]] uint8_t TransformFlags(const EntityID entity) const {
+        uint8_t flags = 0;
+        if (m_ComponentManager->HasComponent<LocalTransformComponent>(entity)) {
+            flags |= HAS_LOCAL_TRANSFORM;
+        }
+        if (m_ComponentManager->HasComponent<LocalToWorldComponent>(entity)) {
+            flags |= HAS_LOCAL_TO_WORLD;
+        }
+        return flags;
+    }
+
+    /** Carries the cached world matrices over to a new hierarchy order or system membership, in one linear
+     *  pass. Entities found at their previous position with the same parent and transform components keep
+     *  their matrix. The others (new, reparented, or with added or removed transform components) are added
+     *  to m_DirtyPositions, and their whole subtree is recomputed.
+     */
+    void RemapCache(const FlatHierarchy &hierarchy) {
+        const auto &entities = hierarchy.GetEntities();
+        const auto &parentPositions = hierarchy.GetParentPositions();
+        const auto count = static_cast<uint32_t>(entities.size());
+
+        for (uint32_t position = 0; position < m_CachedEntities.size(); ++position) {
+            const EntityIndex entityIndex = GetEntityIndex(m_CachedEntities[position]);
+            if (entityIndex >= m_PreviousPositions.size()) {
+                m_PreviousPositions.resize(entityIndex + 1, FlatHierarchy::NO_POSITION);
+            }
+            m_PreviousPositions[entityIndex] = position;
         }
 
-        glm::mat4 localToWorldMatrix = Utils::Math::CalculateWorldMatrix(
-            localTransform.position, localTransform.rotation, localTransform.scale
-        );
+        m_RemappedMatrices.resize(count);
+        m_RemappedParents.resize(count);
+        m_RemappedFlags.resize(count);
+        for (uint32_t position = 0; position < count; ++position) {
+            const EntityID entity = entities[position];
+            const uint32_t parentPosition = parentPositions[position];
+            const EntityID parent = parentPosition != FlatHierarchy::NO_PARENT ? entities[parentPosition] : NULL_ENTITY;
+            const uint8_t flags = TransformFlags(entity);
+            m_RemappedParents[position] = parent;
+            m_RemappedFlags[position] = flags;
 
-        if (m_ComponentManager->HasComponent<ParentComponent>(entity)) {
-            const auto &parentData = m_ComponentManager->GetComponent<ParentComponent>(entity);
-            if (parentData.parent != NULL_ENTITY) {
-                // Recursively compute the parent's world matrix and combine it with the local matrix.
-                localToWorldMatrix = ComputeAndCacheTransformMatrix(parentData.parent) * localToWorldMatrix;
+            const EntityIndex entityIndex = GetEntityIndex(entity);
+            const uint32_t previous = entityIndex < m_PreviousPositions.size()
+                                          ? m_PreviousPositions[entityIndex]
+                                          : FlatHierarchy::NO_POSITION;
+            if (previous != FlatHierarchy::NO_POSITION && m_CachedEntities[previous] == entity &&
+                m_CachedParents[previous] == parent && m_CachedFlags[previous] == flags) {
+                m_RemappedMatrices[position] = m_WorldMatrices[previous];
             } else {
-                LOG_WARN("Entity " + std::to_string(entity) + " parent is NULL_ENTITY");
+                m_DirtyPositions.push_back(position);
             }
         }
 
-        // Cache the computed matrix and mark it as not dirty.
-        localToWorld.localToWorldMatrix = localToWorldMatrix;
-        // localToWorld.isDirty = false;
+        for (const EntityID entity: m_CachedEntities) {
+            m_PreviousPositions[GetEntityIndex(entity)] = FlatHierarchy::NO_POSITION;
+        }
+        std::swap(m_WorldMatrices, m_RemappedMatrices);
+        std::swap(m_CachedParents, m_RemappedParents);
+        std::swap(m_CachedFlags, m_RemappedFlags);
+        m_CachedEntities.assign(entities.begin(), entities.end());
+    }
+
+    /** Versions of GpuTransformData are unique across transform systems, so the renderer never mistakes the
+     *  transforms of a reloaded scene for the ones it already propagated.
+     */
+    static uint64_t NextGpuTransformVersion() {
+        static std::atomic<uint64_t> version = 0;
+        return ++version;
+    }
+
+    /** Stores the local transform of an entity into its GPU transform (identity when it has none).
+     */
+    void GatherGpuTransform(const EntityID entity, GpuLocalTransform &transform) const {
+        glm::vec3 position(0.0f);
+        glm::quat rotation(1.0f, 0.0f, 0.0f, 0.0f);
+        glm::vec3 scale(1.0f);
+        if (m_ComponentManager->HasComponent<LocalTransformComponent>(entity)) {
+            const auto &localTransform = m_ComponentManager->GetComponentReadOnly<LocalTransformComponent>(entity);
+            position = localTransform.position;
+            rotation = localTransform.rotation;
+            scale = localTransform.scale;
+        }
+        transform.position[0] = position.x;
+        transform.position[1] = position.y;
+        transform.position[2] = position.z;
+        transform.rotation[0] = rotation.x;
+        transform.rotation[1] = rotation.y;
+        transform.rotation[2] = rotation.z;
+        transform.rotation[3] = rotation.w;
+        transform.scale[0] = scale.x;
+        transform.scale[1] = scale.y;
+        transform.scale[2] = scale.z;
+    }
 
-        return localToWorldMatrix;
+    /** GPU mode: rebuilds every GPU transform in depth-level order, with parents mapped to their new index.
+     */
+    void RebuildGpuTransforms(const FlatHierarchy &hierarchy) {
+        const auto &entities = hierarchy.GetEntities();
+        const auto &parentPositions = hierarchy.GetParentPositions();
+        const auto count = static_cast<uint32_t>(entities.size());
+
+        m_DirtyRanges.assign(1, {0, count});
+        SortByLevel(hierarchy, m_DirtyRanges);
+
+        // Level order index of each position, reusing the cursors of the sort.
+        m_LevelCursors.resize(count);
+        for (uint32_t index = 0; index < count; ++index) {
+            m_LevelCursors[m_LevelPositions[index]] = index;
+        }
+
+        m_GpuTransforms.transforms.resize(count);
+        m_GpuTransforms.levelOffsets = m_LevelOffsets;
+        m_GpuEntities.resize(count);
+        m_GpuIndices.clear();
+        for (uint32_t index = 0; index < count; ++index) {
+            const uint32_t position = m_LevelPositions[index];
+            const EntityID entity = entities[position];
+            const uint32_t parentPosition = parentPositions[position];
+
+            auto &transform = m_GpuTransforms.transforms[index];
+            GatherGpuTransform(entity, transform);
+            transform.parentIndex = parentPosition != FlatHierarchy::NO_PARENT
+                                        ? m_LevelCursors[parentPosition]
+                                        : NO_GPU_TRANSFORM;
+            transform.padding = 0;
+
+            const EntityIndex entityIndex = GetEntityIndex(entity);
+            if (entityIndex >= m_GpuIndices.size()) {
+                m_GpuIndices.resize(entityIndex + 1, NO_GPU_TRANSFORM);
+            }
+            m_GpuIndices[entityIndex] = index;
+            m_GpuEntities[index] = entity;
+        }
+        m_GpuTransforms.version = NextGpuTransformVersion();
+    }
+
+    /** GPU mode: refreshes the GPU transforms whose LocalTransformComponent was written since the last update.
+     */
+    void UpdateGpuTransforms() {
+        bool changed = false;
+        ChangedTransforms(*m_ComponentManager)
+                .ChangedSince<LocalTransformComponent>(GetLastUpdateVersion())
+                .Each([&](const EntityID entity, const LocalTransformComponent &) {
+                    const uint32_t index = GetGpuTransformIndex(entity);
+                    if (index != NO_GPU_TRANSFORM) {
+                        GatherGpuTransform(entity, m_GpuTransforms.transforms[index]);
+                        changed = true;
+                    }
+                });
+        if (changed) {
+            m_GpuTransforms.version = NextGpuTransformVersion();
+        }
+    }
+
+public:
+    using SystemBase::SystemBase;
+
+    [[nodiscard]] TransformPropagationMode GetMode() const {
+        return m_Mode;
+    }
+
+    void SetMode(const TransformPropagationMode mode) {
+        if (m_Mode != mode) {
+            // The cached matrices or GPU transforms were not maintained by the previous mode.
+            m_OrderVersion = 0;
+            m_MembershipVersion = 0;
+            m_CachedEntities.clear();
+            m_DirtyRanges.clear();
+        }
+        m_Mode = mode;
+    }
+
+    /** GPU mode: local transforms to upload to the renderer.
+     */
+    [[nodiscard]] const GpuTransformData &GetGpuTransforms() const {
+        return m_GpuTransforms;
+    }
+
+    /** GPU mode: index of the entity in GetGpuTransforms, NO_GPU_TRANSFORM when it has not been gathered yet.
+     */
+    [[nodiscard]] uint32_t GetGpuTransformIndex(const EntityID entity) const {
+        const EntityIndex entityIndex = GetEntityIndex(entity);
+        if (entityIndex >= m_GpuIndices.size()) {
+            return NO_GPU_TRANSFORM;
+        }
+        const uint32_t index = m_GpuIndices[entityIndex];
+        return index != NO_GPU_TRANSFORM && m_GpuEntities[index] == entity ? index : NO_GPU_TRANSFORM;
+    }
+
+    [[nodiscard]] SystemAccess GetAccess() const override {
+        SystemAccess access;
+        access.reads.set(ComponentTypeHelper<LocalTransformComponent>::ID);
+        access.reads.set(ComponentTypeHelper<ParentComponent>::ID);
+        access.reads.set(ComponentTypeHelper<LocalToWorldComponent>::ID);
+        access.writes.set(ComponentTypeHelper<LocalToWorldComponent>::ID);
+        return access;
     }
 
     void Update(const float dt) override {
-        for (const auto entity: m_Entities) {
-            // Simply compute and cache the transform matrix for each entity.
-            ComputeAndCacheTransformMatrix(entity);
+        const auto &hierarchy = m_ComponentManager->GetHierarchy();
+        const bool rebuild =
+                hierarchy.GetOrderVersion() != m_OrderVersion || GetMembershipVersion() != m_MembershipVersion;
+        m_OrderVersion = hierarchy.GetOrderVersion();
+        m_MembershipVersion = GetMembershipVersion();
+
+        if (m_Mode == TransformPropagationMode::Gpu) {
+            if (rebuild) {
+                RebuildGpuTransforms(hierarchy);
+            } else {
+                UpdateGpuTransforms();
+            }
+            return;
+        }
+
+        // The ranges written last time are settled before this update writes its own, with the entities of
+        // the cached order they were written for.
+        std::swap(m_SettlingRanges, m_DirtyRanges);
+        for (const auto &[begin, end]: m_SettlingRanges) {
+            SettleRange(begin, end);
+        }
+
+        m_DirtyPositions.clear();
+        if (rebuild) {
+            // Positions moved or the membership changed: cached matrices follow their entities.
+            RemapCache(hierarchy);
+        }
+        ChangedTransforms(*m_ComponentManager)
+                .ChangedSince<LocalTransformComponent>(GetLastUpdateVersion())
+                .Each([&](const EntityID entity, const LocalTransformComponent &) {
+                    m_DirtyPositions.push_back(hierarchy.GetPosition(entity));
+                });
+        std::ranges::sort(m_DirtyPositions);
+
+        // A dirty entity recomputes its whole subtree, which covers its dirty descendants. Adjacent
+        // subtrees are merged into one range, so that batches are not cut at every root.
+        const auto &subtreeSizes = hierarchy.GetSubtreeSizes();
+        m_DirtyRanges.clear();
+        uint32_t coveredEnd = 0;
+        for (const uint32_t position: m_DirtyPositions) {
+            if (position < coveredEnd) {
+                continue;
+            }
+            const bool adjacent = !m_DirtyRanges.empty() && position == coveredEnd;
+            coveredEnd = position + subtreeSizes[position];
+            if (adjacent) {
+                m_DirtyRanges.back().second = coveredEnd;
+            } else {
+                m_DirtyRanges.emplace_back(position, coveredEnd);
+            }
+        }
+
+        size_t dirtyCount = 0;
+        for (const auto &[begin, end]: m_DirtyRanges) {
+            dirtyCount += end - begin;
+        }
+
+        if (Utils::Threading::ThreadPool *threadPool = GetThreadPool();
+            m_Mode == TransformPropagationMode::Parallel && threadPool != nullptr &&
+            dirtyCount >= PARALLEL_MIN_ENTITIES) {
+            ComputeInParallel(hierarchy, dirtyCount, *threadPool);
+        } else {
+            for (const auto &[begin, end]: m_DirtyRanges) {
+                ComputeRange(hierarchy, begin, end, m_Batches[0]);
+            }
+        }
+
+        for (const auto &[begin, end]: m_DirtyRanges) {
+            WriteRange(hierarchy, begin, end);
         }
     }
 };
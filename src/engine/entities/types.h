@@ -3,13 +3,12 @@
 #include <cstdint>
 #include <bitset>
 
-// Define component types with unique integer values
-// to ensure consistent ordering and identification.
-// Update COMPONENTS_COUNT when adding new component types.
+#include "components_system/component_base.h"
+
+// Names of the component types. Type IDs themselves come from ComponentTypes (component_base.h).
 constexpr auto VEE_INTERNAL_COMPONENT_NAME = "InternalTagComponent";
 constexpr auto VEE_PHYSICS_SETTINGS_COMPONENT_NAME = "PhysicsSettings";
 constexpr auto VEE_PARENT_COMPONENT_NAME = "ParentComponent";
-constexpr auto VEE_CHILDREN_COMPONENT_NAME = "ChildrenComponent";
 constexpr auto VEE_CAMERA_COMPONENT_NAME = "CameraComponent";
 constexpr auto VEE_LOCAL_TO_WORLD_COMPONENT_NAME = "LocalToWorldComponent";
 constexpr auto VEE_LOCAL_TRANSFORM_COMPONENT_NAME = "LocalTransformComponent";
@@ -20,15 +19,52 @@ constexpr auto VEE_ACTIVE_CAMERA_TAG_COMPONENT_NAME = "ActiveCameraTagComponent"
 constexpr auto VEE_EDITOR_CAMERA_TAG_COMPONENT_NAME = "EditorCameraTagComponent";
 
 // Total number of distinct component types defined (Components + Tags).
-// This value should match the number of entries in the ComponentType enum.
-constexpr uint16_t COMPONENTS_COUNT = 12;
+constexpr uint16_t COMPONENTS_COUNT = ComponentTypes::Size;
 
 namespace Entities {
+    /** Entity handle: the low ENTITY_INDEX_BITS bits are the slot index, the high bits are the generation
+     * of that slot. Destroying an entity bumps the generation of its slot, so stale handles can be detected.
+     */
     using EntityID = std::uint32_t;
+    using EntityIndex = std::uint32_t;
+    using EntityGeneration = std::uint8_t;
     using Signature = std::bitset<COMPONENTS_COUNT>;
 
+    constexpr std::uint32_t ENTITY_INDEX_BITS = 24;
+    constexpr EntityIndex ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+    constexpr EntityIndex INVALID_ENTITY_INDEX = ~0u;
+
+    /** Generation never given to live entities: handles using it are placeholders for entities
+     * whose creation has been deferred (see EntityCommandBuffer).
+     */
+    constexpr EntityGeneration PENDING_ENTITY_GENERATION = 0xFF;
+
     inline EntityID NULL_ENTITY = 0;
     inline EntityID STARTING_ENTITY_ID = 1;
+
+    constexpr EntityIndex GetEntityIndex(const EntityID entity) {
+        return entity & ENTITY_INDEX_MASK;
+    }
+
+    constexpr EntityGeneration GetEntityGeneration(const EntityID entity) {
+        return static_cast<EntityGeneration>(entity >> ENTITY_INDEX_BITS);
+    }
+
+    constexpr EntityID MakeEntityID(const EntityIndex index, const EntityGeneration generation) {
+        return static_cast<EntityID>(generation) << ENTITY_INDEX_BITS | (index & ENTITY_INDEX_MASK);
+    }
+
+    /** Frame counter stamped on components when they are written through the ECS API (see
+     * ComponentManager::AdvanceChangeVersion). Version 0 is older than every stamp.
+     */
+    using ChangeVersion = std::uint32_t;
+
+    /** Checks whether a component stamped with `changeVersion` was written at or after `sinceVersion`.
+     * The comparison tolerates the counter wrapping around.
+     */
+    constexpr bool IsChangedSince(const ChangeVersion changeVersion, const ChangeVersion sinceVersion) {
+        return sinceVersion == 0 || static_cast<std::int32_t>(changeVersion - sinceVersion) >= 0;
+    }
 }
 
 #endif //GAME_ENGINE_ENTITY_TYPES_H
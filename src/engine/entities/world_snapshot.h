@@ -0,0 +1,137 @@
+#ifndef VEE_WORLD_SNAPSHOT_H
+#define VEE_WORLD_SNAPSHOT_H
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "manager.h"
+#include "types.h"
+#include "components_system/component_base.h"
+#include "components_system/component_column.h"
+
+class ComponentManager;
+
+namespace Entities {
+    /** Differences between two snapshots of the same world, see WorldSnapshot::Diff.
+     */
+    struct WorldSnapshotDiff {
+        struct ComponentChange {
+            EntityID entity;
+            ComponentTypeId typeId;
+        };
+
+        std::vector<EntityID> created;
+        std::vector<EntityID> destroyed;
+        std::vector<EntityID> renamed;
+        std::vector<ComponentChange> added;
+        std::vector<ComponentChange> removed;
+        /** Components written since the older snapshot. Writes are tracked through change versions, so a
+         *  component written with its previous value is reported as well; with archetype storage, versions are
+         *  kept per chunk and every component of a written chunk column is reported.
+         */
+        std::vector<ComponentChange> modified;
+
+        [[nodiscard]] bool Empty() const {
+            return created.empty() && destroyed.empty() && renamed.empty() &&
+                   added.empty() && removed.empty() && modified.empty();
+        }
+    };
+
+    /** In-memory copy of a whole world: entity tables (handles, generations, signatures, names) and every
+     * stored component. Taken and restored by ComponentManager::CaptureSnapshot / RestoreSnapshot, with bulk
+     * copies of the storage: no serialization, no disk and no renderer involved.
+     *
+     * A snapshot can only be restored into the world it was taken from.
+     */
+    class WorldSnapshot {
+        const ComponentManager *m_Source = nullptr;
+        /** First change version that is not part of the snapshot.
+         */
+        ChangeVersion m_ChangeVersion = 0;
+        EntityManager::TableSnapshot m_Entities;
+        std::array<ComponentSnapshot, COMPONENTS_COUNT> m_Components;
+        /** Archetype storage only: signature and entity count of each archetype, in capture order.
+         */
+        std::vector<std::pair<Signature, size_t> > m_Archetypes;
+
+        friend class ::ComponentManager;
+
+        [[nodiscard]] EntityID HandleAt(const EntityIndex index) const {
+            return index < m_Entities.handles.size() ? m_Entities.handles[index] : NULL_ENTITY;
+        }
+
+    public:
+        WorldSnapshot() = default;
+
+        WorldSnapshot(WorldSnapshot &&) = default;
+
+        WorldSnapshot &operator=(WorldSnapshot &&) = default;
+
+        [[nodiscard]] size_t GetEntityCount() const {
+            return m_Entities.activeEntityCount;
+        }
+
+        [[nodiscard]] ChangeVersion GetChangeVersion() const {
+            return m_ChangeVersion;
+        }
+
+        /** Lists what changed between an older and a newer snapshot of the same world.
+         */
+        [[nodiscard]] static WorldSnapshotDiff Diff(const WorldSnapshot &before, const WorldSnapshot &after) {
+            if (before.m_Source != after.m_Source) {
+                throw std::runtime_error("Cannot diff snapshots of different worlds");
+            }
+
+            WorldSnapshotDiff diff;
+            const size_t slotCount = std::max(before.m_Entities.handles.size(), after.m_Entities.handles.size());
+            for (EntityIndex index = STARTING_ENTITY_ID; index < slotCount; ++index) {
+                const EntityID previous = before.HandleAt(index);
+                const EntityID current = after.HandleAt(index);
+                if (previous != current) {
+                    if (previous != NULL_ENTITY) {
+                        diff.destroyed.push_back(previous);
+                    }
+                    if (current != NULL_ENTITY) {
+                        diff.created.push_back(current);
+                    }
+                    continue;
+                }
+                if (current == NULL_ENTITY) {
+                    continue;
+                }
+
+                if (before.m_Entities.names[index] != after.m_Entities.names[index]) {
+                    diff.renamed.push_back(current);
+                }
+                const Signature &previousSignature = before.m_Entities.signatures[index];
+                const Signature &currentSignature = after.m_Entities.signatures[index];
+                const Signature changed = previousSignature ^ currentSignature;
+                for (size_t typeId = 0; typeId < COMPONENTS_COUNT; ++typeId) {
+                    if (changed.test(typeId)) {
+                        auto &changes = currentSignature.test(typeId) ? diff.added : diff.removed;
+                        changes.push_back({current, static_cast<ComponentTypeId>(typeId)});
+                    }
+                }
+            }
+
+            for (size_t typeId = 0; typeId < COMPONENTS_COUNT; ++typeId) {
+                const auto &components = after.m_Components[typeId];
+                for (size_t row = 0; row < components.entities.size(); ++row) {
+                    const EntityID entity = components.entities[row];
+                    const EntityIndex index = GetEntityIndex(entity);
+                    if (before.HandleAt(index) == entity &&
+                        before.m_Entities.signatures[index].test(typeId) &&
+                        IsChangedSince(components.versions[row], before.m_ChangeVersion)) {
+                        diff.modified.push_back({entity, static_cast<ComponentTypeId>(typeId)});
+                    }
+                }
+            }
+            return diff;
+        }
+    };
+}
+
+#endif //VEE_WORLD_SNAPSHOT_H
@@ -16,6 +16,47 @@ void AbstractRenderer::EnqueuePostInitTask(const RendererInitTask &task) {
         }
 }
 
+void AbstractRenderer::UpdateCameraMatrix(const glm::mat4x4 &viewMatrix, const glm::mat4x4 &projectionMatrix) {
+        auto &snapshot = m_RenderSnapshots[m_RecordingSnapshot];
+        snapshot.viewMatrix = viewMatrix;
+        snapshot.projectionMatrix = projectionMatrix;
+}
+
+void AbstractRenderer::SubmitDrawCall(
+        const std::uint32_t entityId,
+        const glm::mat4x4 &worldMatrix,
+        const uint32_t meshId,
+        const uint32_t textureId,
+        const uint32_t transformIndex
+) {
+        m_RenderSnapshots[m_RecordingSnapshot].drawPackets.push_back({
+                worldMatrix,
+                entityId,
+                meshId,
+                textureId,
+                transformIndex
+        });
+}
+
+void AbstractRenderer::UploadGpuTransforms(const GpuTransformData &data) {
+        auto &snapshot = m_RenderSnapshots[m_RecordingSnapshot];
+        if (snapshot.gpuTransforms.version != data.version) {
+                snapshot.gpuTransforms = data;
+        }
+        snapshot.hasGpuTransforms = true;
+}
+
+void AbstractRenderer::PublishRenderSnapshot() {
+        m_RecordingSnapshot ^= 1;
+        auto &snapshot = m_RenderSnapshots[m_RecordingSnapshot];
+        snapshot.drawPackets.clear();
+        snapshot.hasGpuTransforms = false;
+}
+
+void AbstractRenderer::ClearRenderSnapshots() {
+        m_RenderSnapshots = {};
+}
+
 void AbstractRenderer::ExecuteInitTasks() {
         for (const auto &task: m_InitQueue) {
                 task();
@@ -1,8 +1,11 @@
 #ifndef GAME_ENGINE_ABSTRACT_H
 #define GAME_ENGINE_ABSTRACT_H
+#include <array>
 #include <glm/mat4x4.hpp>
 
 #include "imgui.h"
+#include "gpu_transforms.h"
+#include "render_snapshot.h"
 #include "../entities/types.h"
 #include "../models/mesh_manager/mesh_manager.h"
 #include "../models/texture_manager/vulkan_texture_manager.h"
@@ -11,6 +14,9 @@ struct PushData {
     glm::mat4 worldMatrix;
     TextureId textureID;
     Entities::EntityID entityID;
+    /** Index of the world matrix computed on the GPU (see GpuTransformData), NO_GPU_TRANSFORM to use worldMatrix.
+     */
+    uint32_t transformIndex;
 };
 
 using RendererInitTask = std::function<void()>;
@@ -25,6 +31,11 @@ class AbstractRenderer {
     std::shared_ptr<MeshManager> m_MeshManager;
     std::shared_ptr<Vulkan::TextureManager> m_TextureManager;
 
+    /** Double-buffered frame data: the submissions below record into one snapshot while Draw reads the other.
+     */
+    std::array<RenderSnapshot, 2> m_RenderSnapshots;
+    uint32_t m_RecordingSnapshot = 0;
+
 protected:
     std::vector<RendererInitTask> m_InitQueue;
     std::vector<RendererCleanupTask> m_CleanupStack;
@@ -54,16 +65,37 @@ public:
 
     virtual void Draw() = 0;
 
-    virtual void UpdateCameraMatrix(
+    /** Records the camera of the next frame.
+     */
+    void UpdateCameraMatrix(
         const glm::mat4x4 &viewMatrix,
         const glm::mat4x4 &projectionMatrix
-    ) = 0;
+    );
 
-    virtual void SubmitDrawCall(
+    /** Records a draw call of the next frame.
+     */
+    void SubmitDrawCall(
         std::uint32_t entityId,
         const glm::mat4x4 &worldMatrix,
-        uint32_t meshId, uint32_t textureId
-    ) = 0;
+        uint32_t meshId, uint32_t textureId,
+        uint32_t transformIndex
+    );
+
+    /** Whether the renderer can propagate transforms itself, see UploadGpuTransforms.
+     */
+    [[nodiscard]] virtual bool SupportsGpuTransforms() const {
+        return false;
+    }
+
+    /** Local transforms to propagate on the GPU before drawing the next frame; draw calls then refer to the world
+     *  matrices by index. The data is copied into the next frame, unless its version was already recorded.
+     */
+    void UploadGpuTransforms(const GpuTransformData &data);
+
+    /** Hands the recorded frame over to Draw, and starts recording the next one into the other snapshot.
+     *  Must not be called while Draw runs (see RenderThread).
+     */
+    void PublishRenderSnapshot();
 
     virtual void Cleanup() = 0;
 
@@ -81,11 +113,23 @@ public:
 
     virtual ~AbstractRenderer() = default;
 
+    /** Called on the main thread before each frame is published, while Draw is not running.
+     */
     virtual void PrepareForRendering() {
     }
 
 protected:
     void ExecuteInitTasks();
+
+    /** The frame to draw, left untouched by the submissions until the next PublishRenderSnapshot.
+     */
+    [[nodiscard]] const RenderSnapshot &GetPublishedRenderSnapshot() const {
+        return m_RenderSnapshots[m_RecordingSnapshot ^ 1];
+    }
+
+    /** Drops both snapshots, e.g. when the scene they were recorded from is unloaded.
+     */
+    void ClearRenderSnapshots();
 };
 
 
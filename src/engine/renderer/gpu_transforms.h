@@ -0,0 +1,42 @@
+#ifndef VEE_GPU_TRANSFORMS_H
+#define VEE_GPU_TRANSFORMS_H
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/** Index of an entity without a transform on the GPU: its draw calls use the world matrix of the push constants.
+ */
+constexpr uint32_t NO_GPU_TRANSFORM = std::numeric_limits<uint32_t>::max();
+
+/** Local transform of one entity as read by the transform propagation shader (std430 layout, 48 bytes).
+ *  Plain floats rather than glm types, whose alignment depends on the GLM configuration.
+ */
+struct GpuLocalTransform {
+    float position[3];
+    /** Index of the parent in GpuTransformData::transforms, NO_GPU_TRANSFORM for roots.
+     */
+    uint32_t parentIndex;
+    /** Quaternion as x, y, z, w.
+     */
+    float rotation[4];
+    float scale[3];
+    uint32_t padding;
+};
+
+static_assert(sizeof(GpuLocalTransform) == 48, "GpuLocalTransform must match the std430 layout of the shader");
+
+/** Local transforms uploaded to the renderer, which propagates them into world matrices on the GPU.
+ *
+ * Transforms are sorted by depth level, level `d` being [levelOffsets[d], levelOffsets[d + 1]), so parents
+ * always come from an earlier level and the transforms of a level can be computed concurrently.
+ */
+struct GpuTransformData {
+    std::vector<GpuLocalTransform> transforms;
+    std::vector<uint32_t> levelOffsets;
+    /** Changes whenever `transforms` does, so unchanged data is neither uploaded nor propagated again. 0 until
+     *  the first update.
+     */
+    uint64_t version = 0;
+};
+
+#endif //VEE_GPU_TRANSFORMS_H
@@ -0,0 +1,37 @@
+#ifndef VEE_RENDER_SNAPSHOT_H
+#define VEE_RENDER_SNAPSHOT_H
+#include <vector>
+#include <glm/mat4x4.hpp>
+
+#include "gpu_transforms.h"
+#include "../entities/types.h"
+
+/** One mesh to draw, as submitted by the DisplaySystem.
+ */
+struct DrawPacket {
+    glm::mat4 worldMatrix;
+    Entities::EntityID entityId;
+    std::uint32_t meshId;
+    std::uint32_t textureId;
+    /** Index of the world matrix computed on the GPU, NO_GPU_TRANSFORM to use worldMatrix.
+     */
+    std::uint32_t transformIndex;
+};
+
+/** Everything the renderer reads from the scene to draw one frame.
+ *
+ * The simulation records a snapshot while the renderer draws the previous one (see
+ * AbstractRenderer::PublishRenderSnapshot), so a published snapshot is never written to until it is recycled.
+ */
+struct RenderSnapshot {
+    glm::mat4 viewMatrix{1.0f};
+    glm::mat4 projectionMatrix{1.0f};
+    std::vector<DrawPacket> drawPackets;
+    /** Copy of the transforms uploaded for the frame, only valid when hasGpuTransforms is set. Kept when the
+     *  snapshot is recycled, so unchanged transforms (same version) are not copied again.
+     */
+    GpuTransformData gpuTransforms;
+    bool hasGpuTransforms = false;
+};
+
+#endif //VEE_RENDER_SNAPSHOT_H
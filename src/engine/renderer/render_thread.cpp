@@ -0,0 +1,65 @@
+#include "render_thread.h"
+
+RenderThread::RenderThread(const std::shared_ptr<AbstractRenderer> &renderer) : m_Renderer(renderer) {
+    m_Thread = std::thread(&RenderThread::Loop, this);
+}
+
+RenderThread::~RenderThread() {
+    {
+        std::unique_lock lock(m_Mutex);
+        m_Condition.wait(lock, [this] { return !m_FramePending; });
+        m_Stopping = true;
+    }
+    m_Condition.notify_all();
+    m_Thread.join();
+}
+
+void RenderThread::Loop() {
+    while (true) {
+        {
+            std::unique_lock lock(m_Mutex);
+            m_Condition.wait(lock, [this] { return m_FramePending || m_Stopping; });
+            if (m_Stopping) {
+                return;
+            }
+        }
+
+        std::exception_ptr error;
+        try {
+            m_Renderer->Draw();
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard lock(m_Mutex);
+            m_FramePending = false;
+            if (error && !m_Error) {
+                m_Error = error;
+            }
+        }
+        m_Condition.notify_all();
+    }
+}
+
+void RenderThread::Wait() {
+    std::unique_lock lock(m_Mutex);
+    m_Condition.wait(lock, [this] { return !m_FramePending; });
+    if (m_Error) {
+        std::rethrow_exception(std::exchange(m_Error, nullptr));
+    }
+}
+
+void RenderThread::SubmitFrame() {
+    Wait();
+
+    // The render thread is idle: the renderer and both snapshots belong to the main thread until notified.
+    m_Renderer->PrepareForRendering();
+    m_Renderer->PublishRenderSnapshot();
+
+    {
+        std::lock_guard lock(m_Mutex);
+        m_FramePending = true;
+    }
+    m_Condition.notify_all();
+}
@@ -0,0 +1,54 @@
+#ifndef VEE_RENDER_THREAD_H
+#define VEE_RENDER_THREAD_H
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "abstract.h"
+
+/** Dedicated thread drawing the frames of a renderer, so that recording and presenting frame N overlaps the
+ * simulation of frame N + 1 on the main thread.
+ *
+ * The main thread keeps recording into the renderer's current snapshot while the render thread draws the
+ * published one. SubmitFrame is the only synchronization point: it waits for the previous frame, lets the
+ * renderer prepare on the main thread (e.g. swapchain recreation), publishes the snapshot and starts drawing it.
+ *
+ * Anything else touching renderer resources (loading meshes or textures, Reset, Cleanup) must Wait first.
+ */
+class RenderThread {
+    std::shared_ptr<AbstractRenderer> m_Renderer;
+    std::thread m_Thread;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    bool m_FramePending = false;
+    bool m_Stopping = false;
+    /** First exception thrown by Draw, rethrown on the main thread by Wait.
+     */
+    std::exception_ptr m_Error;
+
+    void Loop();
+
+public:
+    explicit RenderThread(const std::shared_ptr<AbstractRenderer> &renderer);
+
+    RenderThread(const RenderThread &) = delete;
+
+    RenderThread &operator=(const RenderThread &) = delete;
+
+    /** Waits for the frame in flight, then stops and joins the thread.
+     */
+    ~RenderThread();
+
+    /** Publishes the recorded snapshot and draws it on the render thread, once the previous frame is drawn.
+     */
+    void SubmitFrame();
+
+    /** Blocks until the render thread is idle, and rethrows the error of the last frame if it failed.
+     */
+    void Wait();
+};
+
+#endif //VEE_RENDER_THREAD_H
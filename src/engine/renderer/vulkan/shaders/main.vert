@@ -4,6 +4,7 @@ layout(push_constant) uniform PushConstants {
     mat4 model;
     uint textureId;
     uint entityId;
+    uint transformIndex;
 } pcs;
 
 layout(set = 1, binding = 0) uniform UniformBufferObject {
@@ -11,6 +12,13 @@ layout(set = 1, binding = 0) uniform UniformBufferObject {
     mat4 proj;
 } ubo;
 
+// World matrices propagated by transforms.comp, used unless transformIndex is NO_GPU_TRANSFORM.
+layout(std430, set = 2, binding = 1) readonly buffer WorldMatrices {
+    mat4 worldMatrices[];
+};
+
+const uint NO_GPU_TRANSFORM = 0xFFFFFFFFu;
+
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec2 inTexCoord;
@@ -19,7 +27,8 @@ layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
 
 void main() {
-    gl_Position = ubo.proj * ubo.view * pcs.model * vec4(inPosition, 1.0);
+    mat4 model = pcs.transformIndex == NO_GPU_TRANSFORM ? pcs.model : worldMatrices[pcs.transformIndex];
+    gl_Position = ubo.proj * ubo.view * model * vec4(inPosition, 1.0);
     fragColor = inColor;
     fragTexCoord = inTexCoord;
 }
\ No newline at end of file
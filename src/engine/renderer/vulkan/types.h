@@ -13,6 +13,13 @@ namespace Vulkan {
         glm::mat4 proj;
     };
 
+    /** Push constants of the transform compute shader: the depth level to propagate.
+     */
+    struct TransformLevelPushData {
+        uint32_t first;
+        uint32_t count;
+    };
+
 
     struct QueueFamilyIndices {
         std::optional<uint32_t> graphicsFamily;
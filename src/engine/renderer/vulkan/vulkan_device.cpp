@@ -308,7 +308,8 @@ Vulkan::QueueFamilyIndices Vulkan::VulkanDevice::FindQueueFamilies(const VkPhysi
 
     int i = 0;
     for (const auto &queueFamily: queueFamilies) {
-        if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+        // Transform propagation dispatches compute work in the frame command buffer.
+        if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT && queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) {
             indices.graphicsFamily = i;
         }
 
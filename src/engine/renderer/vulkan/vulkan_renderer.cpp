@@ -114,12 +114,16 @@ namespace Vulkan {
         CreateMainRenderPass();
         CreateDescriptorSetLayout();
         CreateGraphicsPipeline();
+        CreateTransformPipeline();
     }
 
     void Renderer::CreateBuffers() {
         CreateVertexBuffer();
         CreateIndexBuffer();
         CreateUniformBuffers();
+        for (auto &buffers: m_TransformBuffers) {
+            CreateTransformBuffers(buffers, MIN_GPU_TRANSFORM_CAPACITY);
+        }
     }
 
     void Renderer::CreateDescriptorAndSyncObjects() {
@@ -354,6 +358,65 @@ namespace Vulkan {
             0,
             nullptr
         );
+
+        std::array<VkDescriptorSetLayout, MAX_FRAMES_IN_FLIGHT> transformLayouts{};
+        transformLayouts.fill(m_TransformDescriptorSetLayout);
+        std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> transformSets{};
+        const VkDescriptorSetAllocateInfo transformAlloc{
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            .descriptorPool = m_DescriptorPool,
+            .descriptorSetCount = MAX_FRAMES_IN_FLIGHT,
+            .pSetLayouts = transformLayouts.data()
+        };
+
+        if (
+            vkAllocateDescriptorSets(
+                m_Device->GetLogicalDevice(),
+                &transformAlloc,
+                transformSets.data()
+            ) != VK_SUCCESS
+        ) {
+            throw std::runtime_error("failed to allocate transform descriptor sets!");
+        }
+
+        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+            m_TransformBuffers[i].descriptorSet = transformSets[i];
+            WriteTransformDescriptorSet(m_TransformBuffers[i]);
+        }
+    }
+
+    void Renderer::WriteTransformDescriptorSet(const GpuTransformBuffers &buffers) const {
+        const VkDescriptorBufferInfo localInfo{
+            .buffer = buffers.localBuffer,
+            .offset = 0,
+            .range = VK_WHOLE_SIZE
+        };
+        const VkDescriptorBufferInfo worldInfo{
+            .buffer = buffers.worldBuffer,
+            .offset = 0,
+            .range = VK_WHOLE_SIZE
+        };
+
+        VkWriteDescriptorSet localWrite{};
+        localWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        localWrite.dstSet = buffers.descriptorSet;
+        localWrite.dstBinding = 0;
+        localWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        localWrite.descriptorCount = 1;
+        localWrite.pBufferInfo = &localInfo;
+
+        VkWriteDescriptorSet worldWrite = localWrite;
+        worldWrite.dstBinding = 1;
+        worldWrite.pBufferInfo = &worldInfo;
+
+        const std::array writes = {localWrite, worldWrite};
+        vkUpdateDescriptorSets(
+            m_Device->GetLogicalDevice(),
+            writes.size(),
+            writes.data(),
+            0,
+            nullptr
+        );
     }
 
     void Renderer::CreateDescriptorPool() {
@@ -361,19 +424,21 @@ namespace Vulkan {
                 m_Device->GetPhysicalDeviceProperties().limits.
                 maxDescriptorSetSampledImages;
 
-        std::array<VkDescriptorPoolSize, 3> poolSizes{};
+        std::array<VkDescriptorPoolSize, 4> poolSizes{};
         poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         poolSizes[0].descriptorCount = 1;
         poolSizes[1].type = VK_DESCRIPTOR_TYPE_SAMPLER;
         poolSizes[1].descriptorCount = 1;
         poolSizes[2].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
         poolSizes[2].descriptorCount = maxBindlessTextures;
+        poolSizes[3].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSizes[3].descriptorCount = 2 * MAX_FRAMES_IN_FLIGHT; // Local transforms and world matrices
 
         VkDescriptorPoolCreateInfo poolInfo{};
         poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
         poolInfo.pPoolSizes = poolSizes.data();
-        poolInfo.maxSets = 2;
+        poolInfo.maxSets = 2 + MAX_FRAMES_IN_FLIGHT;
         poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
 
         if (vkCreateDescriptorPool(
@@ -622,7 +687,11 @@ namespace Vulkan {
         pushConstantRange.offset = 0;
         pushConstantRange.size = sizeof(PushData);
 
-        const std::array layouts = {m_BindlessDescriptorSetLayout, m_DynamicDescriptorSetLayout};
+        const std::array layouts = {
+            m_BindlessDescriptorSetLayout,
+            m_DynamicDescriptorSetLayout,
+            m_TransformDescriptorSetLayout
+        };
 
         VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
         pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
@@ -677,6 +746,105 @@ namespace Vulkan {
         );
     }
 
+    void Renderer::CreateTransformPipeline() {
+        using namespace Shaders;
+
+        const auto computePath = "../src/engine/renderer/vulkan/shaders/transforms.comp";
+
+        const auto computeShaderModule = m_ShaderModuleCache->GetOrCreateShaderModule(
+            computePath,
+            ShaderType::Compute
+        );
+
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(TransformLevelPushData);
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &m_TransformDescriptorSetLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+        if (
+            vkCreatePipelineLayout(
+                m_Device->GetLogicalDevice(),
+                &pipelineLayoutInfo,
+                nullptr,
+                &m_TransformPipelineLayout
+            ) != VK_SUCCESS
+        ) {
+            throw std::runtime_error("failed to create transform pipeline layout!");
+        }
+
+        VkComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipelineInfo.stage.module = computeShaderModule;
+        pipelineInfo.stage.pName = "main";
+        pipelineInfo.layout = m_TransformPipelineLayout;
+
+        if (
+            vkCreateComputePipelines(
+                m_Device->GetLogicalDevice(),
+                VK_NULL_HANDLE,
+                1,
+                &pipelineInfo,
+                nullptr,
+                &m_TransformPipeline
+            ) != VK_SUCCESS
+        ) {
+            throw std::runtime_error("failed to create transform pipeline!");
+        }
+
+        m_ShaderModuleCache->DestroyShaderModule(
+            computePath,
+            ShaderType::Compute
+        );
+    }
+
+    void Renderer::CreateTransformBuffers(GpuTransformBuffers &buffers, const uint32_t capacity) const {
+        CreateBuffer(
+            capacity * sizeof(GpuLocalTransform),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VMA_MEMORY_USAGE_AUTO,
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+            buffers.localBuffer,
+            buffers.localAllocation,
+            "Local Transform Buffer"
+        );
+        buffers.localMapped = m_Device->GetAllocationInfo(buffers.localAllocation).pMappedData;
+
+        CreateBuffer(
+            capacity * sizeof(glm::mat4),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+            0,
+            buffers.worldBuffer,
+            buffers.worldAllocation,
+            "World Matrix Buffer"
+        );
+        buffers.capacity = capacity;
+        buffers.version = 0;
+    }
+
+    void Renderer::DestroyTransformBuffers(GpuTransformBuffers &buffers) const {
+        if (buffers.localBuffer)
+            m_Device->DestroyBuffer(buffers.localBuffer, buffers.localAllocation);
+        if (buffers.worldBuffer)
+            m_Device->DestroyBuffer(buffers.worldBuffer, buffers.worldAllocation);
+
+        buffers.localBuffer = VK_NULL_HANDLE;
+        buffers.localAllocation = VK_NULL_HANDLE;
+        buffers.localMapped = nullptr;
+        buffers.worldBuffer = VK_NULL_HANDLE;
+        buffers.worldAllocation = VK_NULL_HANDLE;
+        buffers.capacity = 0;
+    }
+
     void Renderer::CreateDescriptorSetLayout() {
         const auto maxBindlessTextures = m_Device->GetPhysicalDeviceProperties().limits.maxDescriptorSetSampledImages;
 
@@ -750,6 +918,40 @@ namespace Vulkan {
         ) {
             throw std::runtime_error("failed to create bindless descriptor set layout!");
         }
+
+        // Transform Layout: local transforms, world matrices
+        VkDescriptorSetLayoutBinding localTransformBinding{};
+        localTransformBinding.binding = 0;
+        localTransformBinding.descriptorCount = 1;
+        localTransformBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        localTransformBinding.pImmutableSamplers = nullptr;
+        localTransformBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+        VkDescriptorSetLayoutBinding worldMatrixBinding{};
+        worldMatrixBinding.binding = 1;
+        worldMatrixBinding.descriptorCount = 1;
+        worldMatrixBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        worldMatrixBinding.pImmutableSamplers = nullptr;
+        worldMatrixBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+
+        const std::array transformBindings = {
+            localTransformBinding,
+            worldMatrixBinding
+        };
+        VkDescriptorSetLayoutCreateInfo transformLayoutInfo{};
+        transformLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        transformLayoutInfo.bindingCount = transformBindings.size();
+        transformLayoutInfo.pBindings = transformBindings.data();
+
+        if (vkCreateDescriptorSetLayout(
+                m_Device->GetLogicalDevice(),
+                &transformLayoutInfo,
+                nullptr,
+                &m_TransformDescriptorSetLayout
+            ) != VK_SUCCESS
+        ) {
+            throw std::runtime_error("failed to create transform descriptor set layout!");
+        }
     }
 
     VkRenderPass Renderer::CreateGraphicsRenderPass(
@@ -993,11 +1195,14 @@ namespace Vulkan {
             &dynamicOffset
         );
 
-        for (const auto &drawCall: m_DrawQueue) {
+        BindTransformDescriptorSet(commandBuffer);
+
+        for (const auto &drawCall: GetPublishedRenderSnapshot().drawPackets) {
             PushData pushData = {
                 drawCall.worldMatrix,
                 drawCall.textureId,
                 drawCall.entityId,
+                drawCall.transformIndex
             };
 
             vkCmdPushConstants(
@@ -1019,11 +1224,129 @@ namespace Vulkan {
         }
 
         vkCmdEndRenderPass(commandBuffer);
+    }
+
+    void Renderer::BindTransformDescriptorSet(const VkCommandBuffer &cmd) const {
+        vkCmdBindDescriptorSets(
+            cmd,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            m_PipelineLayout,
+            2,
+            1,
+            &m_TransformBuffers[m_CurrentFrameIndex].descriptorSet,
+            0,
+            nullptr
+        );
+    }
+
+    void Renderer::AddTransformPass() {
+        if (!m_PropagateTransforms) return;
+
+        m_RenderGraph->AddPass({
+            .name = "TransformPass",
+            .execute = [this](const VkCommandBuffer &cmd) {
+                RecordTransformPropagation(cmd);
+            },
+            .usages = {}
+        });
+    }
+
+    void Renderer::RecordTransformPropagation(const VkCommandBuffer &cmd) const {
+        const auto &buffers = m_TransformBuffers[m_CurrentFrameIndex];
+        const auto &levelOffsets = GetPublishedRenderSnapshot().gpuTransforms.levelOffsets;
+        const uint32_t maxGroupCount = m_Device->GetPhysicalDeviceProperties().limits.maxComputeWorkGroupCount[0];
+        const uint32_t maxDispatchSize = maxGroupCount * TRANSFORM_WORKGROUP_SIZE;
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_TransformPipeline);
+        vkCmdBindDescriptorSets(
+            cmd,
+            VK_PIPELINE_BIND_POINT_COMPUTE,
+            m_TransformPipelineLayout,
+            0,
+            1,
+            &buffers.descriptorSet,
+            0,
+            nullptr
+        );
+
+        constexpr VkMemoryBarrier barrier{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_SHADER_READ_BIT
+        };
+
+        for (size_t level = 0; level + 1 < levelOffsets.size(); level++) {
+            if (level > 0) {
+                // The parents of a level are the world matrices written by the previous one.
+                vkCmdPipelineBarrier(
+                    cmd,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    0,
+                    1, &barrier,
+                    0, nullptr,
+                    0, nullptr
+                );
+            }
 
-        m_DrawQueue.clear();
+            for (uint32_t first = levelOffsets[level]; first < levelOffsets[level + 1]; first += maxDispatchSize) {
+                const TransformLevelPushData pushData{
+                    first,
+                    std::min(levelOffsets[level + 1] - first, maxDispatchSize)
+                };
+                vkCmdPushConstants(
+                    cmd, m_TransformPipelineLayout,
+                    VK_SHADER_STAGE_COMPUTE_BIT,
+                    0, sizeof(TransformLevelPushData), &pushData
+                );
+                vkCmdDispatch(cmd, (pushData.count + TRANSFORM_WORKGROUP_SIZE - 1) / TRANSFORM_WORKGROUP_SIZE, 1, 1);
+            }
+        }
+
+        vkCmdPipelineBarrier(
+            cmd,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+            0,
+            1, &barrier,
+            0, nullptr,
+            0, nullptr
+        );
+    }
+
+    void Renderer::PrepareGpuTransforms() {
+        m_PropagateTransforms = false;
+        const auto &snapshot = GetPublishedRenderSnapshot();
+        if (!snapshot.hasGpuTransforms) return;
+
+        const auto &data = snapshot.gpuTransforms;
+        auto &buffers = m_TransformBuffers[m_CurrentFrameIndex];
+        if (data.version == buffers.version) return;
+
+        const auto count = static_cast<uint32_t>(data.transforms.size());
+        if (count > buffers.capacity) {
+            // The fence of the frame was waited on, its buffers are no longer in use.
+            const uint32_t capacity = std::max(count, buffers.capacity * 2);
+            DestroyTransformBuffers(buffers);
+            CreateTransformBuffers(buffers, capacity);
+            WriteTransformDescriptorSet(buffers);
+        }
+
+        const VkDeviceSize size = count * sizeof(GpuLocalTransform);
+        memcpy(buffers.localMapped, data.transforms.data(), size);
+        vmaFlushAllocation(m_Device->GetAllocator(), buffers.localAllocation, 0, size);
+
+        buffers.version = data.version;
+        m_PropagateTransforms = count > 0;
+    }
+
+    bool Renderer::SupportsGpuTransforms() const {
+        return m_TransformPipeline != VK_NULL_HANDLE;
     }
 
     void Renderer::BuildRenderGraph() {
+        AddTransformPass();
+
         m_RenderGraph->AddPass({
             .name = "ScenePass",
             .execute = [this](const VkCommandBuffer &cmd) {
@@ -1072,7 +1395,7 @@ namespace Vulkan {
         );
 
         if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-            RecreateSwapChain();
+            m_SwapchainOutOfDate = true;
             return false;
         }
         if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
@@ -1133,9 +1456,8 @@ namespace Vulkan {
             &presentInfo
         );
 
-        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || m_FramebufferResized) {
-            RecreateSwapChain();
-            m_FramebufferResized = false;
+        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+            m_SwapchainOutOfDate = true;
         } else if (result != VK_SUCCESS) {
             throw std::runtime_error("failed to present swap chain image!");
         }
@@ -1146,6 +1468,9 @@ namespace Vulkan {
 
         if (!IsReadyToDraw()) return;
 
+        UpdateCameraUniforms();
+        PrepareGpuTransforms();
+
         const VkCommandBuffer &cmd = m_CommandBuffers[m_CurrentFrameIndex];
         vkResetCommandBuffer(cmd, 0);
 
@@ -1168,11 +1493,20 @@ namespace Vulkan {
         m_TotalFramesRendered++;
     }
 
-    void Renderer::UpdateCameraMatrix(const glm::mat4x4 &viewMatrix, const glm::mat4x4 &projectionMatrix) {
+    void Renderer::PrepareForRendering() {
+        if (m_FramebufferResized || m_SwapchainOutOfDate) {
+            RecreateSwapChain();
+            m_FramebufferResized = false;
+            m_SwapchainOutOfDate = false;
+        }
+    }
+
+    void Renderer::UpdateCameraUniforms() const {
+        const auto &snapshot = GetPublishedRenderSnapshot();
         UniformBufferObject ubo{};
 
-        ubo.view = viewMatrix;
-        ubo.proj = projectionMatrix;
+        ubo.view = snapshot.viewMatrix;
+        ubo.proj = snapshot.projectionMatrix;
         ubo.proj[1][1] *= -1;
 
         const VkDeviceSize offset = m_CurrentFrameIndex * m_PaddedUniformBufferSize;
@@ -1185,20 +1519,6 @@ namespace Vulkan {
         );
     }
 
-    void Renderer::SubmitDrawCall(
-        const EntityID entityId,
-        const glm::mat4x4 &worldMatrix,
-        const uint32_t meshId,
-        const uint32_t textureId
-    ) {
-        m_DrawQueue.push_back({
-            worldMatrix,
-            entityId,
-            meshId,
-            textureId
-        });
-    }
-
     void Renderer::Cleanup() {
         WaitIdle();
 
@@ -1231,8 +1551,11 @@ namespace Vulkan {
                 m_IndexAllocation
             );
 
-        // 4. Destroy Uniform Buffer
+        // 4. Destroy Uniform and Transform Buffers
         m_Device->DestroyBuffer(m_UniformBuffer, m_UniformBufferAllocation);
+        for (auto &buffers: m_TransformBuffers) {
+            DestroyTransformBuffers(buffers);
+        }
 
         // 5. Destroy Swapchain-related resources
         m_Swapchain->Cleanup();
@@ -1249,8 +1572,11 @@ namespace Vulkan {
         // 7. Destroy Pipeline and Layouts
         m_Device->DestroyPipeline(m_GraphicsPipeline);
         m_Device->DestroyPipelineLayout(m_PipelineLayout);
+        m_Device->DestroyPipeline(m_TransformPipeline);
+        m_Device->DestroyPipelineLayout(m_TransformPipelineLayout);
         m_Device->DestroyDescriptorSetLayout(m_BindlessDescriptorSetLayout);
         m_Device->DestroyDescriptorSetLayout(m_DynamicDescriptorSetLayout);
+        m_Device->DestroyDescriptorSetLayout(m_TransformDescriptorSetLayout);
         m_Device->DestroyDescriptorPool(m_DescriptorPool);
         m_Device->DestroySampler(m_TextureSampler);
 
@@ -1269,7 +1595,7 @@ namespace Vulkan {
     void Renderer::Reset() {
         GetMeshManager()->Reset();
         GetTextureManager()->Reset();
-        m_DrawQueue.clear();
+        ClearRenderSnapshots();
     }
 
     void Renderer::WaitIdle() const {
@@ -5,6 +5,7 @@
 #include <vk_mem_alloc.h>
 #include <GLFW/glfw3.h>
 #include <vulkan/vulkan_core.h>
+#include <array>
 
 #include "pipeline_builder.h"
 #include "render_graph.h"
@@ -23,11 +24,27 @@ namespace Vulkan {
 
     constexpr int MAX_FRAMES_IN_FLIGHT = 2;
     constexpr uint64_t MAX_GEOMETRY_BUFFER_SIZE = 256 * 1024 * 1024; // 256 MB
-    struct DrawCall {
-        glm::mat4 worldMatrix;
-        Entities::EntityID entityId;
-        std::uint32_t meshId;
-        std::uint32_t textureId;
+    /** Initial capacity (in transforms) of the GPU transform buffers, doubled when exceeded.
+     */
+    constexpr uint32_t MIN_GPU_TRANSFORM_CAPACITY = 1024;
+    /** local_size_x of the transform compute shader (transforms.comp).
+     */
+    constexpr uint32_t TRANSFORM_WORKGROUP_SIZE = 64;
+
+    /** Transform propagation buffers of one frame in flight: local transforms written by the CPU, world matrices
+     *  computed from them by the transform compute shader and read by the vertex shaders.
+     */
+    struct GpuTransformBuffers {
+        VkBuffer localBuffer = VK_NULL_HANDLE;
+        VmaAllocation localAllocation = VK_NULL_HANDLE;
+        void *localMapped = nullptr;
+        VkBuffer worldBuffer = VK_NULL_HANDLE;
+        VmaAllocation worldAllocation = VK_NULL_HANDLE;
+        uint32_t capacity = 0;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        /** GpuTransformData::version the world matrices were computed from, 0 before the first upload.
+         */
+        uint64_t version = 0;
     };
 
     class Renderer : public AbstractRenderer {
@@ -39,6 +56,10 @@ namespace Vulkan {
 
         std::shared_ptr<Window> m_Window;
         bool m_FramebufferResized = false;
+        /** Set by Draw when the swapchain no longer matches the surface. Draw may run on the render thread,
+         *  so the swapchain is recreated by PrepareForRendering, on the main thread.
+         */
+        bool m_SwapchainOutOfDate = false;
 
         std::shared_ptr<VulkanDevice> m_Device;
 
@@ -61,12 +82,18 @@ namespace Vulkan {
         VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
         VkPipeline m_GraphicsPipeline = VK_NULL_HANDLE;
 
+        VkDescriptorSetLayout m_TransformDescriptorSetLayout = VK_NULL_HANDLE;
+        VkPipelineLayout m_TransformPipelineLayout = VK_NULL_HANDLE;
+        VkPipeline m_TransformPipeline = VK_NULL_HANDLE;
+        std::array<GpuTransformBuffers, MAX_FRAMES_IN_FLIGHT> m_TransformBuffers{};
+        /** Whether the current frame records the transform propagation.
+         */
+        bool m_PropagateTransforms = false;
+
         std::vector<VkCommandBuffer> m_CommandBuffers;
 
         VkSampler m_TextureSampler = VK_NULL_HANDLE;
 
-        std::vector<DrawCall> m_DrawQueue;
-
         VkBuffer m_VertexBuffer = VK_NULL_HANDLE;
         VmaAllocation m_VertexAllocation = VK_NULL_HANDLE;
         VkBuffer m_IndexBuffer = VK_NULL_HANDLE;
@@ -113,17 +140,11 @@ namespace Vulkan {
 
         void Draw() override;
 
-        void UpdateCameraMatrix(
-            const glm::mat4x4 &viewMatrix,
-            const glm::mat4x4 &projectionMatrix
-        ) override;
+        /** Recreates the swapchain if the window was resized or the last frame found it out of date.
+         */
+        void PrepareForRendering() override;
 
-        void SubmitDrawCall(
-            std::uint32_t entityId,
-            const glm::mat4x4 &worldMatrix,
-            uint32_t meshId,
-            uint32_t textureId
-        ) override;
+        [[nodiscard]] bool SupportsGpuTransforms() const override;
 
         void Cleanup() override;
 
@@ -140,6 +161,15 @@ namespace Vulkan {
     protected:
         virtual void AddResizeCallbacks();
 
+        /** Adds the transform propagation pass when the frame has new GPU transforms. Must come before every
+         *  pass that draws.
+         */
+        void AddTransformPass();
+
+        /** Binds the world matrices of the current frame as descriptor set 2 of m_PipelineLayout.
+         */
+        void BindTransformDescriptorSet(const VkCommandBuffer &cmd) const;
+
     private:
         void InitVulkan();
 
@@ -193,6 +223,25 @@ namespace Vulkan {
 
         void CreateGraphicsPipeline();
 
+        void CreateTransformPipeline();
+
+        void CreateTransformBuffers(GpuTransformBuffers &buffers, uint32_t capacity) const;
+
+        void DestroyTransformBuffers(GpuTransformBuffers &buffers) const;
+
+        void WriteTransformDescriptorSet(const GpuTransformBuffers &buffers) const;
+
+        /** Copies the camera of the published snapshot into the uniform buffer of the current frame.
+         */
+        void UpdateCameraUniforms() const;
+
+        /** Copies the transforms of the published snapshot into the buffers of the current frame, whose previous
+         *  use is complete.
+         */
+        void PrepareGpuTransforms();
+
+        void RecordTransformPropagation(const VkCommandBuffer &cmd) const;
+
         void CreateDescriptorSetLayout();
 
         [[nodiscard]] VkRenderPass CreateGraphicsRenderPass(VkImageLayout finalColorLayout) const;
@@ -10,7 +10,6 @@
 #include "../entities/system/camera_system.h"
 #include "../../editor/systems/editor_camera_system.h"
 #include "../entities/components_system/components/parent_component.h"
-#include "../entities/components_system/components/children_component.h"
 #include "../entities/components_system/components/local_to_world_component.h"
 #include "../entities/components_system/components/physics_settings_component.h"
 #include "../entities/components_system/components/player_controller_component.h"
@@ -31,6 +30,9 @@ void Scene::SetPath(const std::string &path) {
 }
 
 bool Scene::DestroyEntity(const EntityID entity) const {
+    if (!m_EntityManager->IsAlive(entity)) {
+        return false;
+    }
     if (m_ComponentManager->HasComponent<InternalTagComponent>(entity)) {
         return false;
     }
@@ -64,7 +66,7 @@ void Scene::RegisterInternalSystems() {
     Signature transformSignature;
     transformSignature.set(ComponentTypeHelper<LocalTransformComponent>::ID);
     transformSignature.set(ComponentTypeHelper<LocalToWorldComponent>::ID);
-    m_SystemManager->RegisterSystem<TransformSystem>(
+    m_TransformSystem = m_SystemManager->RegisterSystem<TransformSystem>(
         std::make_shared<TransformSystem>(m_ComponentManager)
     );
     m_SystemManager->SetSignature<TransformSystem>(transformSignature);
@@ -76,7 +78,8 @@ void Scene::RegisterInternalSystems() {
         std::make_shared<DisplaySystem>(
             m_Renderer,
             m_ComponentManager,
-            m_EntityManager
+            m_EntityManager,
+            m_TransformSystem
         )
     );
     m_SystemManager->SetSignature<DisplaySystem>(renderableSignature);
@@ -86,7 +89,6 @@ void Scene::RegisterInternalComponents() const {
     m_ComponentManager->RegisterComponent<InternalTagComponent>(VEE_INTERNAL_COMPONENT_NAME);
     m_ComponentManager->RegisterComponent<PhysicsSettingsComponent>(VEE_PHYSICS_SETTINGS_COMPONENT_NAME);
     m_ComponentManager->RegisterComponent<ParentComponent>(VEE_PARENT_COMPONENT_NAME);
-    m_ComponentManager->RegisterComponent<ChildrenComponent>(VEE_CHILDREN_COMPONENT_NAME);
     m_ComponentManager->RegisterComponent<LocalTransformComponent>(VEE_LOCAL_TRANSFORM_COMPONENT_NAME);
     m_ComponentManager->RegisterComponent<LocalToWorldComponent>(VEE_LOCAL_TO_WORLD_COMPONENT_NAME);
     m_ComponentManager->RegisterComponent<VelocityComponent>(VEE_VELOCITY_COMPONENT_NAME);
@@ -12,10 +12,15 @@ namespace Vulkan {
 
 class Scene {
     std::shared_ptr<AbstractRenderer> m_Renderer;
+    /** Backs every ECS container of the scene, so unloading the scene releases its memory in a few large
+     *  blocks instead of one free per entity or component.
+     */
+    std::shared_ptr<Utils::MemoryArena> m_MemoryArena;
     std::shared_ptr<EntityManager> m_EntityManager;
     std::shared_ptr<ComponentManager> m_ComponentManager;
     std::shared_ptr<SystemManager> m_SystemManager;
 
+    std::shared_ptr<TransformSystem> m_TransformSystem;
     std::shared_ptr<DisplaySystem> m_DisplaySystem;
 
     std::string m_Name = "Untitled Scene";
@@ -29,13 +34,15 @@ public:
     explicit Scene(
         const std::string &path,
         const std::shared_ptr<AbstractRenderer> &renderer,
-        const std::vector<SystemRegistrationFunction> &systemRegistrations
+        const std::vector<SystemRegistrationFunction> &systemRegistrations,
+        const ComponentStorageMode storageMode = ComponentStorageMode::PerType
     ) : m_Renderer(renderer) {
         m_Path = path;
 
-        m_EntityManager = std::make_shared<EntityManager>();
+        m_MemoryArena = std::make_shared<Utils::MemoryArena>();
+        m_EntityManager = std::make_shared<EntityManager>(m_MemoryArena);
         m_SystemManager = std::make_shared<SystemManager>();
-        m_ComponentManager = std::make_shared<ComponentManager>(m_SystemManager, m_EntityManager);
+        m_ComponentManager = std::make_shared<ComponentManager>(m_SystemManager, m_EntityManager, storageMode);
 
         RegisterInternalComponents();
         RegisterInternalSystems();
@@ -68,6 +75,14 @@ public:
         return m_SystemManager;
     }
 
+    [[nodiscard]] std::shared_ptr<Utils::MemoryArena> GetMemoryArena() const {
+        return m_MemoryArena;
+    }
+
+    [[nodiscard]] std::shared_ptr<TransformSystem> GetTransformSystem() const {
+        return m_TransformSystem;
+    }
+
     [[nodiscard]] std::shared_ptr<DisplaySystem> GetDisplaySystem() const {
         return m_DisplaySystem;
     }
@@ -80,6 +95,37 @@ public:
         return m_EntityManager->CreateEntity(name);
     }
 
+    /** Creates `count` entities owning the components `Ts`, see ComponentManager::CreateEntities.
+     */
+    template<typename... Ts, typename Initializer>
+    std::vector<EntityID> CreateEntities(const size_t count, const std::string &name, Initializer &&initializer) const {
+        return m_ComponentManager->CreateEntities<Ts...>(count, name, std::forward<Initializer>(initializer));
+    }
+
+    /** Captures an entity subtree into a prefab, see ComponentManager::CreatePrefab.
+     */
+    [[nodiscard]] Prefab CreatePrefab(const EntityID root) const {
+        return m_ComponentManager->CreatePrefab(root);
+    }
+
+    /** Creates `count` copies of the prefab, see ComponentManager::InstantiatePrefab.
+     */
+    std::vector<EntityID> InstantiatePrefab(const Prefab &prefab, const size_t count = 1) const {
+        return m_ComponentManager->InstantiatePrefab(prefab, count);
+    }
+
+    /** Copies the whole world of the scene, see ComponentManager::CaptureSnapshot.
+     */
+    [[nodiscard]] WorldSnapshot CaptureSnapshot() const {
+        return m_ComponentManager->CaptureSnapshot();
+    }
+
+    /** Restores a snapshot taken from this scene, see ComponentManager::RestoreSnapshot.
+     */
+    void RestoreSnapshot(const WorldSnapshot &snapshot) const {
+        m_ComponentManager->RestoreSnapshot(snapshot);
+    }
+
     [[nodiscard]] std::shared_ptr<AbstractRenderer> GetRenderer() const {
         return m_Renderer;
     }
@@ -89,7 +135,7 @@ public:
     void SetPath(const std::string &path);
 
     /**
-     * Removes an entity from the scene if it is not tagged as internal.
+     * Removes an entity from the scene if it is alive and not tagged as internal.
      * Returns true if the entity was successfully destroyed, false otherwise.
      */
     [[nodiscard]] bool DestroyEntity(EntityID entity) const;
@@ -1,11 +1,12 @@
 #include "scene_serializer.h"
 
 #include <fstream>
+#include <utility>
+#include <vector>
 
 #include "../engine.h"
 #include "../entities/components_system/components/camera_component.h"
 #include "../entities/components_system/components/local_transform_component.h"
-#include "../entities/components_system/components/children_component.h"
 #include "../entities/components_system/components/local_to_world_component.h"
 #include "../entities/components_system/components/parent_component.h"
 #include "../entities/components_system/components/player_controller_component.h"
@@ -98,10 +99,15 @@ void operator>>(const YAML::Node &node, PlayerControllerComponent &c) {
     node["move_right_key"] >> c.moveRightKey;
 }
 
+/** Child and parent of each ParentComponent read from a scene, applied once every entity exists.
+ */
+using ParentLinks = std::vector<std::pair<EntityID, EntityID> >;
+
 void DeserializeComponentV0(
     const YAML::Node &componentNode,
     const EntityID entityId,
-    const std::unique_ptr<Scene> &scenePtr
+    const std::unique_ptr<Scene> &scenePtr,
+    ParentLinks &parentLinks
 ) {
     const auto componentType = componentNode["type"];
     if (!componentType) {
@@ -114,7 +120,7 @@ void DeserializeComponentV0(
     if (typeStr == VEE_PARENT_COMPONENT_NAME) {
         ParentComponent parent{};
         componentNode >> parent;
-        Utils::Entities::Hierarchy::SetParent(entityId, parent.parent, componentManager);
+        parentLinks.emplace_back(entityId, parent.parent);
     } else if (typeStr == VEE_LOCAL_TRANSFORM_COMPONENT_NAME) {
         LocalTransformComponent transform{};
         componentNode >> transform;
@@ -145,7 +151,7 @@ void DeserializeComponentV0(
 };
 
 void DeserializeEntityV0(
-    const YAML::Node &entityNode, const std::unique_ptr<Scene> &scenePtr) {
+    const YAML::Node &entityNode, const std::unique_ptr<Scene> &scenePtr, ParentLinks &parentLinks) {
     std::string entityName;
     if (entityNode["name"]) {
         entityName = entityNode["name"].as<std::string>();
@@ -165,7 +171,7 @@ void DeserializeEntityV0(
 
     for (const auto &component: components) {
         DeserializeComponentV0(
-            component, entityId, scenePtr
+            component, entityId, scenePtr, parentLinks
         );
     }
 };
@@ -175,8 +181,15 @@ void DeserializeSceneV0(
     const std::unique_ptr<Scene> &scenePtr
 ) {
     if (const auto entities = data["entities"]) {
+        // Parents are applied once every entity exists: scenes saved before they were written in hierarchy
+        // order can list a child before its parent.
+        ParentLinks parentLinks;
         for (auto entityNode: entities) {
-            DeserializeEntityV0(entityNode, scenePtr);
+            DeserializeEntityV0(entityNode, scenePtr, parentLinks);
+        }
+        const auto componentManager = scenePtr->GetComponentManager();
+        for (const auto &[child, parent]: parentLinks) {
+            Utils::Entities::Hierarchy::SetParent(child, parent, componentManager);
         }
     } else {
         std::cerr << "[WARN] No entities found in scene." << std::endl;
@@ -205,9 +218,10 @@ void DeserializeSceneV0(
 std::unique_ptr<Scene> SceneSerializer::LoadScene(
     const std::string &scenePath,
     const std::shared_ptr<AbstractRenderer> &renderer,
-    const std::vector<SystemRegistrationFunction> &systemRegistrations
+    const std::vector<SystemRegistrationFunction> &systemRegistrations,
+    const ComponentStorageMode storageMode
 ) {
-    auto scene = std::make_unique<Scene>(scenePath, renderer, systemRegistrations);
+    auto scene = std::make_unique<Scene>(scenePath, renderer, systemRegistrations, storageMode);
 
     YAML::Node data;
     try {
@@ -296,7 +310,8 @@ void SerializeSceneV0(
     const auto entityManager = scene->GetEntityManager();
     const auto componentManager = scene->GetComponentManager();
 
-    for (auto &[entity, name]: entityManager->GetAllEntities()) {
+    // Saved in hierarchy order, so that parents are loaded before their children.
+    for (const EntityID entity: componentManager->GetHierarchy().GetEntities()) {
         if (componentManager->HasComponent<InternalTagComponent>(entity)) {
             // Skip internal entities
             continue;
@@ -304,7 +319,7 @@ void SerializeSceneV0(
 
         out << YAML::BeginMap;
         out << YAML::Key << "id" << YAML::Value << entity;
-        out << YAML::Key << "name" << YAML::Value << name;
+        out << YAML::Key << "name" << YAML::Value << entityManager->GetEntityName(entity).data();
 
         out << YAML::Key << "components" << YAML::Value << YAML::BeginSeq;
 
@@ -312,10 +327,7 @@ void SerializeSceneV0(
         for (const auto &componentType: componentTypes) {
             const auto componentTypeName = componentManager->GetComponentName(componentType);
 
-            if (
-                componentType == ComponentTypeHelper<LocalToWorldComponent>::ID
-                || componentType == ComponentTypeHelper<ChildrenComponent>::ID
-            ) {
+            if (componentType == ComponentTypeHelper<LocalToWorldComponent>::ID) {
                 // This component is derived, no need to serialize
                 continue;
             }
@@ -324,15 +336,15 @@ void SerializeSceneV0(
             out << YAML::Key << "type" << YAML::Value << componentTypeName;
 
             if (componentType == ComponentTypeHelper<ParentComponent>::ID) {
-                out << componentManager->GetComponent<ParentComponent>(entity);
+                out << componentManager->GetComponentReadOnly<ParentComponent>(entity);
             } else if (componentType == ComponentTypeHelper<LocalTransformComponent>::ID) {
-                out << componentManager->GetComponent<LocalTransformComponent>(entity);
+                out << componentManager->GetComponentReadOnly<LocalTransformComponent>(entity);
             } else if (componentType == ComponentTypeHelper<CameraComponent>::ID) {
-                out << componentManager->GetComponent<CameraComponent>(entity);
+                out << componentManager->GetComponentReadOnly<CameraComponent>(entity);
             } else if (componentType == ComponentTypeHelper<VelocityComponent>::ID) {
-                out << componentManager->GetComponent<VelocityComponent>(entity);
+                out << componentManager->GetComponentReadOnly<VelocityComponent>(entity);
             } else if (componentType == ComponentTypeHelper<RenderableComponent>::ID) {
-                out << componentManager->GetComponent<RenderableComponent>(entity);
+                out << componentManager->GetComponentReadOnly<RenderableComponent>(entity);
             } else if (componentType == ComponentTypeHelper<ActiveCameraTagComponent>::ID) {
                 // Tag component, no data to serialize
             } else {
@@ -16,7 +16,8 @@ public:
     static std::unique_ptr<Scene> LoadScene(
         const std::string &scenePath,
         const std::shared_ptr<AbstractRenderer> &renderer,
-        const std::vector<SystemRegistrationFunction> &systemRegistrations
+        const std::vector<SystemRegistrationFunction> &systemRegistrations,
+        ComponentStorageMode storageMode = ComponentStorageMode::PerType
     );
 
     static void SaveScene(
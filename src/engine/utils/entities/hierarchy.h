@@ -10,14 +10,12 @@ using namespace Entities;
 namespace Utils::Entities::Hierarchy {
     /** Sets a new parent for the specified child entity.
      *
-     * This function updates the ParentComponent of the child entity to reference the new parent entity.
-     * It also updates the ChildrenComponent of both the old and new parent entities to reflect the change
-     * in hierarchy.
+     * The child is moved, with its whole subtree, under the new parent in the hierarchy of the world, and its
+     * ParentComponent is updated (see ComponentManager::SetParent). A NULL_ENTITY parent makes it a root.
      *
      * @param child The ID of the child entity whose parent is to be changed.
      * @param newParent The ID of the new parent entity.
      * @param componentManager A shared pointer to the ComponentManager for accessing and modifying components.
-     * @param entityManager A shared pointer to the EntityManager for managing entities.
      */
     void SetParent(
         EntityID child,
@@ -27,13 +25,12 @@ namespace Utils::Entities::Hierarchy {
 
     /** Adds a child entity to the specified parent entity.
      *
-     * This function updates the ParentComponent of the child entity to reference the parent entity.
-     * It also updates the ChildrenComponent of the parent entity to include the new child.
+     * The child is detached from its previous parent, if any, and appended after the other children of the
+     * parent.
      *
      * @param parent The ID of the parent entity.
      * @param child The ID of the child entity to be added.
      * @param componentManager A shared pointer to the ComponentManager for accessing and modifying components.
-     * @param entityManager A shared pointer to the EntityManager for managing entities.
      */
     void AddChild(
         EntityID parent,
@@ -1,8 +1,207 @@
 #ifndef VEE_UTILS_ENTITIES_ITERATION_H
 #define VEE_UTILS_ENTITIES_ITERATION_H
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../../entities/components_system/component_manager.h"
 
 namespace Utils::Entities::Iteration {
+    /** Typed query over every entity owning all the components `Ts`.
+     *
+     * Component references are taken straight from the underlying storage:
+     * - In ComponentStorageMode::Archetype, matching chunks are walked column by column.
+     * - In ComponentStorageMode::PerType, the smallest array drives the iteration and the other
+     *   arrays are probed through their sparse index (a couple of array loads, no hashing).
+     *
+     * `const` component types are read-only: they are handed to callbacks as const references and only
+     * appear in the read signature. Mutable types appear in both the read and write signatures, which
+     * describes the access pattern of the view to the system scheduler.
+     *
+     * Mutable components are marked as changed when they are handed out (per component in PerType mode,
+     * per chunk column in Archetype mode). ChangedSince() restricts the view to entities whose components
+     * were written since a given ChangeVersion; arrays and chunks without such writes are skipped whole.
+     * In Archetype mode the filter has chunk granularity, so unchanged neighbours of a changed entity match too.
+     *
+     * Tag components (see IS_TAG_COMPONENT) have no storage: they can be excluded, but not iterated.
+     *
+     * Structural changes (adding/removing components, destroying entities) must not happen while iterating.
+     */
+    template<typename... Ts>
+    class View {
+        static_assert(sizeof...(Ts) > 0, "A view needs at least one component type");
+        static_assert((!IS_TAG_COMPONENT<std::remove_const_t<Ts> > && ...), "Tag components cannot be iterated");
+
+        template<typename T>
+        using Stored = std::remove_const_t<T>;
+
+        template<typename T>
+        static constexpr bool INCLUDES = (std::is_same_v<T, Stored<Ts> > || ...);
+
+        ComponentManager &m_ComponentManager;
+        Signature m_Excluded;
+        Signature m_Changed;
+        ChangeVersion m_ChangedSince = 0;
+
+        /** Checks whether the component of type Is was written since m_ChangedSince, given its version.
+         */
+        template<size_t I>
+        [[nodiscard]] bool IsFilteredChange(const ChangeVersion version) const {
+            return m_Changed.test(ComponentTypeHelper<Stored<std::tuple_element_t<I, std::tuple<Ts...> > > >::ID)
+                   && IsChangedSince(version, m_ChangedSince);
+        }
+
+        template<typename Func>
+        static void Invoke(Func &func, const EntityID entity, Ts &... components) {
+            if constexpr (std::is_invocable_v<Func &, EntityID, Ts &...>) {
+                func(entity, components...);
+            } else {
+                func(components...);
+            }
+        }
+
+        template<typename Func, size_t... Is>
+        void EachInArchetypes(Func &func, std::index_sequence<Is...>) {
+            const ChangeVersion version = m_ComponentManager.m_ChangeVersion;
+            const bool hasChangeFilter = m_Changed.any();
+            const auto &entityManager = *m_ComponentManager.m_EntityManager;
+            const Signature excludedTags = m_Excluded & m_ComponentManager.m_TagSignature;
+            const bool hasExcludedTags = excludedTags.any();
+
+            m_ComponentManager.m_ArchetypeStorage.ForEachChunk(
+                GetIncludedSignature(),
+                [&](const Archetype &archetype, ArchetypeChunk &chunk) {
+                    if ((archetype.GetSignature() & m_Excluded).any()) {
+                        return;
+                    }
+
+                    if (hasChangeFilter) {
+                        if (!(IsFilteredChange<Is>(
+                            archetype.GetChangeVersion(chunk, ComponentTypeHelper<Stored<Ts> >::ID)) || ...)) {
+                            return;
+                        }
+                    }
+                    ((std::is_const_v<Ts>
+                          ? void()
+                          : archetype.MarkChanged(chunk, ComponentTypeHelper<Ts>::ID, version)), ...);
+
+                    const EntityID *entities = archetype.GetEntities(chunk);
+                    const auto columns = std::make_tuple(archetype.template GetColumn<Stored<Ts> >(chunk)...);
+                    const size_t count = chunk.Count();
+
+                    std::apply([&](auto *... column) {
+                        for (size_t row = 0; row < count; ++row) {
+                            // Tags are not part of archetype signatures, only of entity signatures.
+                            if (hasExcludedTags &&
+                                (entityManager.GetSignatureUnchecked(entities[row]) & excludedTags).any()) {
+                                continue;
+                            }
+                            Invoke(func, entities[row], column[row]...);
+                        }
+                    }, columns);
+                }
+            );
+        }
+
+        template<typename Func, size_t... Is>
+        void EachInArrays(Func &func, std::index_sequence<Is...>) {
+            const auto arrays = std::make_tuple(m_ComponentManager.GetComponentArray<Stored<Ts> >()...);
+            if (((std::get<Is>(arrays) == nullptr) || ...)) {
+                return;
+            }
+
+            const bool hasChangeFilter = m_Changed.any();
+            if (hasChangeFilter && !(IsFilteredChange<Is>(std::get<Is>(arrays)->GetChangeVersion()) || ...)) {
+                return;
+            }
+            const ChangeVersion version = m_ComponentManager.m_ChangeVersion;
+
+            // Drive the iteration with the smallest array.
+            const std::pmr::vector<EntityID> *driver = &std::get<0>(arrays)->GetEntities();
+            ((std::get<Is>(arrays)->Size() < driver->size()
+                  ? void(driver = &std::get<Is>(arrays)->GetEntities())
+                  : void()), ...);
+
+            const auto &entityManager = *m_ComponentManager.m_EntityManager;
+            const bool hasExclusions = m_Excluded.any();
+
+            for (const EntityID entity: *driver) {
+                if (hasExclusions && (entityManager.GetSignatureUnchecked(entity) & m_Excluded).any()) {
+                    continue;
+                }
+
+                const std::array<uint32_t, sizeof...(Ts)> indices{std::get<Is>(arrays)->IndexOf(entity)...};
+                if (((indices[Is] == SparseSet::INVALID_INDEX) || ...)) {
+                    continue;
+                }
+                if (hasChangeFilter &&
+                    !(IsFilteredChange<Is>(std::get<Is>(arrays)->GetChangeVersionAt(indices[Is])) || ...)) {
+                    continue;
+                }
+                ((std::is_const_v<Ts> ? void() : std::get<Is>(arrays)->MarkChanged(indices[Is], version)), ...);
+
+                Invoke(func, entity, std::get<Is>(arrays)->GetAt(indices[Is])...);
+            }
+        }
+
+    public:
+        explicit View(ComponentManager &componentManager) : m_ComponentManager(componentManager) {
+        }
+
+        /** Components every matched entity must have.
+         */
+        [[nodiscard]] static Signature GetIncludedSignature() {
+            Signature signature;
+            (signature.set(ComponentTypeHelper<Stored<Ts> >::ID), ...);
+            return signature;
+        }
+
+        /** Components read by the view (every included component).
+         */
+        [[nodiscard]] static Signature GetReadSignature() {
+            return GetIncludedSignature();
+        }
+
+        /** Components the view can modify (included components not declared `const`).
+         */
+        [[nodiscard]] static Signature GetWriteSignature() {
+            Signature signature;
+            ((std::is_const_v<Ts> ? void() : void(signature.set(ComponentTypeHelper<Stored<Ts> >::ID))), ...);
+            return signature;
+        }
+
+        /** Skips entities owning any of the given components.
+         */
+        template<typename... Excluded>
+        View &Exclude() {
+            (m_Excluded.set(ComponentTypeHelper<Excluded>::ID), ...);
+            return *this;
+        }
+
+        /** Only keeps entities for which at least one of the components `Changed` (which must be part of `Ts`)
+         *  was written at or after `version`, e.g. SystemBase::GetLastUpdateVersion().
+         */
+        template<typename... Changed>
+        View &ChangedSince(const ChangeVersion version) {
+            static_assert(sizeof...(Changed) > 0, "ChangedSince needs at least one component type");
+            static_assert((INCLUDES<std::remove_const_t<Changed> > && ...), "ChangedSince components must be part of the view");
+            (m_Changed.set(ComponentTypeHelper<Changed>::ID), ...);
+            m_ChangedSince = version;
+            return *this;
+        }
+
+        /** Calls `func(EntityID, Ts &...)` or `func(Ts &...)` for every matching entity.
+         */
+        template<typename Func>
+        void Each(Func &&func) {
+            if (m_ComponentManager.GetStorageMode() == ComponentStorageMode::Archetype) {
+                EachInArchetypes(func, std::index_sequence_for<Ts...>{});
+            } else {
+                EachInArrays(func, std::index_sequence_for<Ts...>{});
+            }
+        }
+    };
 }
 
 #endif
-
@@ -1,9 +1,15 @@
 #ifndef GAME_ENGINE_ENTITY_UTILS_H
 #define GAME_ENGINE_ENTITY_UTILS_H
+#include <array>
+#include <bit>
 #include <iterator>
 #include <cstddef>
 #include <iostream>
+#include <limits>
 #include <vector>
+#include "paged_vector.h"
+#include "../entities/component_bitmap_index.h"
+#include "../entities/entity_query.h"
 #include "../entities/types.h"
 
 using namespace Entities;
@@ -18,35 +24,75 @@ namespace Utils::Entities {
         using reference = const EntityID &;
 
     private:
-        const std::vector<Signature> *m_Signatures = nullptr;
-        Signature m_Query;
-        std::size_t m_Index = 0;
+        static constexpr std::size_t END_INDEX = std::numeric_limits<std::size_t>::max();
+
+        const ComponentBitmapIndex *m_Bitmaps = nullptr;
+        const PagedVector<EntityID> *m_Handles = nullptr;
+        std::array<ComponentTypeId, COMPONENTS_COUNT> m_Types{};
+        std::size_t m_TypeCount = 0;
+
+        // Matches of the current block, consumed bit by bit.
+        ComponentBitmapIndex::Block m_Matches{};
+        std::size_t m_Block = 0;
+        std::size_t m_Word = 0;
+
+        std::size_t m_Index = END_INDEX;
         EntityID m_Current = 0;
 
         void advance_to_match() {
-            const auto n = m_Signatures->size();
-            while (m_Index < n) {
-                if (((*m_Signatures)[m_Index] & m_Query) == m_Query) {
-                    m_Current = static_cast<EntityID>(m_Index + STARTING_ENTITY_ID);
+            while (true) {
+                for (; m_Word < ComponentBitmapIndex::BLOCK_WORDS; ++m_Word) {
+                    if (auto &word = m_Matches[m_Word]; word != 0) {
+                        const auto bit = static_cast<std::size_t>(std::countr_zero(word));
+                        word &= word - 1;
+                        m_Index = m_Block * ComponentBitmapIndex::BLOCK_BITS
+                                  + m_Word * ComponentBitmapIndex::WORD_BITS + bit;
+                        m_Current = (*m_Handles)[m_Index];
+                        return;
+                    }
+                }
+
+                if (++m_Block >= m_Bitmaps->GetBlockCount()) {
+                    m_Index = END_INDEX;
                     return;
                 }
-                ++m_Index;
+                m_Bitmaps->MatchBlock(m_Block, m_Types.data(), m_TypeCount, m_Matches);
+                m_Word = 0;
             }
-            m_Index = n;
         }
 
     public:
         EntityMatchIterator() = default;
 
-        EntityMatchIterator(const std::vector<Signature> *signs, Signature query, std::size_t start = 0)
-            : m_Signatures(signs), m_Query(query), m_Index(start) {
-            if (m_Signatures) advance_to_match();
+        /** Iterates over the live entities whose signature contains the query, in index order.
+         *
+         * @param bitmaps Component bitmap index of the entities.
+         * @param handles Live handle of each entity index.
+         * @param query Components every yielded entity must have.
+         * @param end Whether to build the past-the-end iterator.
+         */
+        EntityMatchIterator(
+            const ComponentBitmapIndex *bitmaps,
+            const PagedVector<EntityID> *handles,
+            const Signature query,
+            const bool end = false
+        )
+            : m_Bitmaps(bitmaps), m_Handles(handles) {
+            for (std::size_t typeId = 0; typeId < COMPONENTS_COUNT; ++typeId) {
+                if (query.test(typeId)) {
+                    m_Types[m_TypeCount++] = static_cast<ComponentTypeId>(typeId);
+                }
+            }
+
+            if (!end && m_Bitmaps && m_Bitmaps->GetBlockCount() > 0) {
+                m_Bitmaps->MatchBlock(0, m_Types.data(), m_TypeCount, m_Matches);
+                advance_to_match();
+            }
         }
 
         value_type operator*() const { return m_Current; }
 
         EntityMatchIterator &operator++() {
-            ++m_Index;
             advance_to_match();
             return *this;
         }
@@ -58,29 +104,31 @@ namespace Utils::Entities {
         }
 
         bool operator==(const EntityMatchIterator &o) const {
-            return m_Signatures == o.m_Signatures && m_Index == o.m_Index && m_Query == o.m_Query;
+            return m_Bitmaps == o.m_Bitmaps && m_Index == o.m_Index;
         }
 
         bool operator!=(const EntityMatchIterator &o) const { return !(*this == o); }
     };
 
     struct EntityMatchRange {
-        std::vector<Signature> *m_Signatures;
+        const ComponentBitmapIndex *m_Bitmaps;
+        const PagedVector<EntityID> *m_Handles;
         Signature m_Query;
 
         EntityMatchRange(
-            std::vector<Signature> *signs,
+            const ComponentBitmapIndex *bitmaps,
+            const PagedVector<EntityID> *handles,
             const Signature query
         )
-            : m_Signatures(signs), m_Query(query) {
+            : m_Bitmaps(bitmaps), m_Handles(handles), m_Query(query) {
         }
 
         [[nodiscard]] EntityMatchIterator begin() const {
-            return {m_Signatures, m_Query, 0};
+            return {m_Bitmaps, m_Handles, m_Query};
         }
 
         [[nodiscard]] EntityMatchIterator end() const {
-            return {m_Signatures, m_Query, m_Signatures ? m_Signatures->size() : 0};
+            return {m_Bitmaps, m_Handles, m_Query, true};
         }
     };
 
@@ -92,5 +140,9 @@ namespace Utils::Entities {
         }
         return NULL_ENTITY;
     }
+
+    inline EntityID GetFirstEntityWithSignature(const EntityQuery &query) {
+        return query.GetFirst();
+    }
 }
 #endif //GAME_ENGINE_ENTITY_UTILS_H
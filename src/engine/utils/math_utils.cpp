@@ -1,21 +1,327 @@
 #include "math_utils.h"
 
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+static_assert(sizeof(glm::mat4x4) == 16 * sizeof(float), "The SIMD kernels expect tightly packed matrices");
+
+namespace {
+#if defined(__AVX2__) || defined(__SSE2__)
+    float *ColumnPointer(glm::mat4x4 &matrix, const int column) {
+        return &matrix[column][0];
+    }
+
+    const float *ColumnPointer(const glm::mat4x4 &matrix, const int column) {
+        return &matrix[column][0];
+    }
+#endif
+
+    /** Scaled rotation columns and translation of one transform, as laid out in its world matrix.
+     */
+    glm::mat4x4 ComposeWorldMatrix(
+        const float px, const float py, const float pz,
+        const float qx, const float qy, const float qz, const float qw,
+        const float sx, const float sy, const float sz
+    ) {
+        const float xx = qx * qx, yy = qy * qy, zz = qz * qz;
+        const float xy = qx * qy, xz = qx * qz, yz = qy * qz;
+        const float wx = qw * qx, wy = qw * qy, wz = qw * qz;
+
+        glm::mat4x4 matrix;
+        matrix[0] = glm::vec4((1.0f - 2.0f * (yy + zz)) * sx, 2.0f * (xy + wz) * sx, 2.0f * (xz - wy) * sx, 0.0f);
+        matrix[1] = glm::vec4(2.0f * (xy - wz) * sy, (1.0f - 2.0f * (xx + zz)) * sy, 2.0f * (yz + wx) * sy, 0.0f);
+        matrix[2] = glm::vec4(2.0f * (xz + wy) * sz, 2.0f * (yz - wx) * sz, (1.0f - 2.0f * (xx + yy)) * sz, 0.0f);
+        matrix[3] = glm::vec4(px, py, pz, 1.0f);
+        return matrix;
+    }
+
+    /** Extracts the scale and rotation of a world matrix, with a negative x scale for mirroring matrices.
+     *  Returns false when a scale is zero, as no rotation can be extracted then.
+     */
+    bool DecomposeBasis(const glm::mat4x4 &matrix, glm::vec3 &scale, glm::quat &rotation) {
+        constexpr float MIN_SCALE = 1e-6f;
+
+        glm::mat3 basis(matrix);
+        scale = glm::vec3(glm::length(basis[0]), glm::length(basis[1]), glm::length(basis[2]));
+        if (scale.x < MIN_SCALE || scale.y < MIN_SCALE || scale.z < MIN_SCALE) {
+            return false;
+        }
+        if (glm::determinant(basis) < 0.0f) {
+            scale.x = -scale.x;
+        }
+
+        basis[0] /= scale.x;
+        basis[1] /= scale.y;
+        basis[2] /= scale.z;
+        rotation = glm::quat_cast(basis);
+        return true;
+    }
+
+#if defined(__AVX2__)
+    constexpr size_t COMPOSE_LANES = 8;
+
+    /** Transposes the x, y, z, w rows of one matrix column for 8 transforms and stores the column of each.
+     */
+    void StoreColumn(
+        const __m256 x, const __m256 y, const __m256 z, const __m256 w,
+        glm::mat4x4 *matrices, const int column
+    ) {
+        const __m256 xy0 = _mm256_unpacklo_ps(x, y);
+        const __m256 xy1 = _mm256_unpackhi_ps(x, y);
+        const __m256 zw0 = _mm256_unpacklo_ps(z, w);
+        const __m256 zw1 = _mm256_unpackhi_ps(z, w);
+        const __m256 lanes[4] = {
+            _mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(1, 0, 1, 0)),
+            _mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(3, 2, 3, 2)),
+            _mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(1, 0, 1, 0)),
+            _mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(3, 2, 3, 2)),
+        };
+        for (int lane = 0; lane < 4; ++lane) {
+            _mm_storeu_ps(ColumnPointer(matrices[lane], column), _mm256_castps256_ps128(lanes[lane]));
+            _mm_storeu_ps(ColumnPointer(matrices[lane + 4], column), _mm256_extractf128_ps(lanes[lane], 1));
+        }
+    }
+
+    void ComposeLanes(const Utils::Math::TransformArrays &transforms, const size_t first, glm::mat4x4 *matrices) {
+        const __m256 qx = _mm256_loadu_ps(transforms.rotationX.data() + first);
+        const __m256 qy = _mm256_loadu_ps(transforms.rotationY.data() + first);
+        const __m256 qz = _mm256_loadu_ps(transforms.rotationZ.data() + first);
+        const __m256 qw = _mm256_loadu_ps(transforms.rotationW.data() + first);
+        const __m256 sx = _mm256_loadu_ps(transforms.scaleX.data() + first);
+        const __m256 sy = _mm256_loadu_ps(transforms.scaleY.data() + first);
+        const __m256 sz = _mm256_loadu_ps(transforms.scaleZ.data() + first);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 two = _mm256_set1_ps(2.0f);
+        const __m256 zero = _mm256_setzero_ps();
+
+        const __m256 xx = _mm256_mul_ps(qx, qx), yy = _mm256_mul_ps(qy, qy), zz = _mm256_mul_ps(qz, qz);
+        const __m256 xy = _mm256_mul_ps(qx, qy), xz = _mm256_mul_ps(qx, qz), yz = _mm256_mul_ps(qy, qz);
+        const __m256 wx = _mm256_mul_ps(qw, qx), wy = _mm256_mul_ps(qw, qy), wz = _mm256_mul_ps(qw, qz);
+
+        StoreColumn(
+            _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))), sx),
+            _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx),
+            _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx),
+            zero, matrices, 0
+        );
+        StoreColumn(
+            _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy),
+            _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))), sy),
+            _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy),
+            zero, matrices, 1
+        );
+        StoreColumn(
+            _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz),
+            _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz),
+            _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))), sz),
+            zero, matrices, 2
+        );
+        StoreColumn(
+            _mm256_loadu_ps(transforms.positionX.data() + first),
+            _mm256_loadu_ps(transforms.positionY.data() + first),
+            _mm256_loadu_ps(transforms.positionZ.data() + first),
+            one, matrices, 3
+        );
+    }
+#elif defined(__SSE2__)
+    constexpr size_t COMPOSE_LANES = 4;
+
+    /** Transposes the x, y, z, w rows of one matrix column for 4 transforms and stores the column of each.
+     */
+    void StoreColumn(__m128 x, __m128 y, __m128 z, __m128 w, glm::mat4x4 *matrices, const int column) {
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        _mm_storeu_ps(ColumnPointer(matrices[0], column), x);
+        _mm_storeu_ps(ColumnPointer(matrices[1], column), y);
+        _mm_storeu_ps(ColumnPointer(matrices[2], column), z);
+        _mm_storeu_ps(ColumnPointer(matrices[3], column), w);
+    }
+
+    void ComposeLanes(const Utils::Math::TransformArrays &transforms, const size_t first, glm::mat4x4 *matrices) {
+        const __m128 qx = _mm_loadu_ps(transforms.rotationX.data() + first);
+        const __m128 qy = _mm_loadu_ps(transforms.rotationY.data() + first);
+        const __m128 qz = _mm_loadu_ps(transforms.rotationZ.data() + first);
+        const __m128 qw = _mm_loadu_ps(transforms.rotationW.data() + first);
+        const __m128 sx = _mm_loadu_ps(transforms.scaleX.data() + first);
+        const __m128 sy = _mm_loadu_ps(transforms.scaleY.data() + first);
+        const __m128 sz = _mm_loadu_ps(transforms.scaleZ.data() + first);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 two = _mm_set1_ps(2.0f);
+        const __m128 zero = _mm_setzero_ps();
+
+        const __m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+        const __m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+        const __m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+
+        StoreColumn(
+            _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx),
+            _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx),
+            _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx),
+            zero, matrices, 0
+        );
+        StoreColumn(
+            _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy),
+            _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy),
+            _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy),
+            zero, matrices, 1
+        );
+        StoreColumn(
+            _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz),
+            _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz),
+            _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz),
+            zero, matrices, 2
+        );
+        StoreColumn(
+            _mm_loadu_ps(transforms.positionX.data() + first),
+            _mm_loadu_ps(transforms.positionY.data() + first),
+            _mm_loadu_ps(transforms.positionZ.data() + first),
+            one, matrices, 3
+        );
+    }
+#endif
+}
+
+void Utils::Math::TransformArrays::Resize(const size_t count) {
+    for (auto *array: {
+             &positionX, &positionY, &positionZ,
+             &rotationX, &rotationY, &rotationZ, &rotationW,
+             &scaleX, &scaleY, &scaleZ
+         }) {
+        array->resize(count);
+    }
+}
+
+void Utils::Math::TransformArrays::Set(
+    const size_t index,
+    const glm::vec3 position,
+    const glm::quat rotation,
+    const glm::vec3 scale
+) {
+    positionX[index] = position.x;
+    positionY[index] = position.y;
+    positionZ[index] = position.z;
+    rotationX[index] = rotation.x;
+    rotationY[index] = rotation.y;
+    rotationZ[index] = rotation.z;
+    rotationW[index] = rotation.w;
+    scaleX[index] = scale.x;
+    scaleY[index] = scale.y;
+    scaleZ[index] = scale.z;
+}
+
+void Utils::Math::TransformArrays::SetIdentity(const size_t index) {
+    Set(index, glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f));
+}
+
 glm::mat4x4 Utils::Math::CalculateWorldMatrix(
     const glm::vec3 position,
     const glm::quat rotation,
     const glm::vec3 scale
 ) {
-    const auto translationMatrix = glm::translate(
-        glm::mat4(1.0f),
-        position
-    );
-    const auto rotationMatrix = glm::mat4_cast(
-        rotation
+    return ComposeWorldMatrix(
+        position.x, position.y, position.z,
+        rotation.x, rotation.y, rotation.z, rotation.w,
+        scale.x, scale.y, scale.z
     );
-    const auto scaleMatrix = glm::scale(
-        glm::mat4(1.0f),
-        scale
+}
+
+glm::mat4x4 Utils::Math::InterpolateWorldMatrix(
+    const glm::mat4x4 &from,
+    const glm::mat4x4 &to,
+    const float alpha
+) {
+    glm::vec3 fromScale, toScale;
+    glm::quat fromRotation, toRotation;
+    if (!DecomposeBasis(from, fromScale, fromRotation) || !DecomposeBasis(to, toScale, toRotation)) {
+        return from + (to - from) * alpha;
+    }
+
+    const glm::quat rotation = glm::slerp(fromRotation, toRotation, alpha);
+    return CalculateWorldMatrix(
+        glm::mix(glm::vec3(from[3]), glm::vec3(to[3]), alpha),
+        glm::normalize(rotation),
+        glm::mix(fromScale, toScale, alpha)
     );
+}
+
+void Utils::Math::ComposeWorldMatrices(
+    const TransformArrays &transforms,
+    const size_t first,
+    const size_t count,
+    glm::mat4x4 *matrices
+) {
+    size_t index = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+    for (; index + COMPOSE_LANES <= count; index += COMPOSE_LANES) {
+        ComposeLanes(transforms, first + index, matrices + index);
+    }
+#endif
+    for (; index < count; ++index) {
+        const size_t i = first + index;
+        matrices[index] = ComposeWorldMatrix(
+            transforms.positionX[i], transforms.positionY[i], transforms.positionZ[i],
+            transforms.rotationX[i], transforms.rotationY[i], transforms.rotationZ[i], transforms.rotationW[i],
+            transforms.scaleX[i], transforms.scaleY[i], transforms.scaleZ[i]
+        );
+    }
+}
+
+void Utils::Math::MultiplyWorldMatrices(
+    const size_t count,
+    const glm::mat4x4 *const *parents,
+    const glm::mat4x4 *locals,
+    glm::mat4x4 *results
+) {
+    for (size_t index = 0; index < count; ++index) {
+        const glm::mat4x4 &local = locals[index];
+        glm::mat4x4 &result = results[index];
+        if (parents[index] == nullptr) {
+            result = local;
+            continue;
+        }
+        const glm::mat4x4 &parent = *parents[index];
 
-    return translationMatrix * rotationMatrix * scaleMatrix;
+#if defined(__AVX2__)
+        // Each half of a register holds one column: two columns of the result per iteration.
+        const __m256 p0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(ColumnPointer(parent, 0)));
+        const __m256 p1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(ColumnPointer(parent, 1)));
+        const __m256 p2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(ColumnPointer(parent, 2)));
+        const __m256 p3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(ColumnPointer(parent, 3)));
+        for (int column = 0; column < 4; column += 2) {
+            const __m256 l = _mm256_loadu_ps(ColumnPointer(local, column));
+            const __m256 r = _mm256_add_ps(
+                _mm256_add_ps(
+                    _mm256_mul_ps(p0, _mm256_permute_ps(l, 0x00)),
+                    _mm256_mul_ps(p1, _mm256_permute_ps(l, 0x55))
+                ),
+                _mm256_add_ps(
+                    _mm256_mul_ps(p2, _mm256_permute_ps(l, 0xAA)),
+                    _mm256_mul_ps(p3, _mm256_permute_ps(l, 0xFF))
+                )
+            );
+            _mm256_storeu_ps(ColumnPointer(result, column), r);
+        }
+#elif defined(__SSE2__)
+        const __m128 p0 = _mm_loadu_ps(ColumnPointer(parent, 0));
+        const __m128 p1 = _mm_loadu_ps(ColumnPointer(parent, 1));
+        const __m128 p2 = _mm_loadu_ps(ColumnPointer(parent, 2));
+        const __m128 p3 = _mm_loadu_ps(ColumnPointer(parent, 3));
+        for (int column = 0; column < 4; ++column) {
+            const __m128 l = _mm_loadu_ps(ColumnPointer(local, column));
+            const __m128 r = _mm_add_ps(
+                _mm_add_ps(
+                    _mm_mul_ps(p0, _mm_shuffle_ps(l, l, 0x00)),
+                    _mm_mul_ps(p1, _mm_shuffle_ps(l, l, 0x55))
+                ),
+                _mm_add_ps(
+                    _mm_mul_ps(p2, _mm_shuffle_ps(l, l, 0xAA)),
+                    _mm_mul_ps(p3, _mm_shuffle_ps(l, l, 0xFF))
+                )
+            );
+            _mm_storeu_ps(ColumnPointer(result, column), r);
+        }
+#else
+        result = parent * local;
+#endif
+    }
 }
@@ -1,15 +1,73 @@
 #ifndef GAME_ENGINE_MATH_H
 #define GAME_ENGINE_MATH_H
+#include <cstddef>
+#include <vector>
+
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
 
 namespace Utils::Math {
+    /** Translation, rotation and scale of a batch of transforms as a structure of arrays:
+     * element `i` of every array belongs to transform `i`.
+     */
+    struct TransformArrays {
+        std::vector<float> positionX, positionY, positionZ;
+        std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+        std::vector<float> scaleX, scaleY, scaleZ;
+
+        [[nodiscard]] size_t Size() const {
+            return positionX.size();
+        }
+
+        void Resize(size_t count);
+
+        void Set(size_t index, glm::vec3 position, glm::quat rotation, glm::vec3 scale);
+
+        /** Sets transform `index` to the identity.
+         */
+        void SetIdentity(size_t index);
+    };
+
+    /** Composes translation * rotation * scale directly from the quaternion, without building and
+     * multiplying the three matrices. The rotation is expected to be normalized.
+     */
     glm::mat4x4 CalculateWorldMatrix(
         glm::vec3 position,
         glm::quat rotation,
         glm::vec3 scale
     );
+
+    /** Blends two world matrices for rendering between simulation steps: translations and scales are
+     * interpolated linearly and rotations spherically, so rotating objects keep their size. Matrices with shear
+     * are approximated by their closest rotation and scale.
+     */
+    glm::mat4x4 InterpolateWorldMatrix(
+        const glm::mat4x4 &from,
+        const glm::mat4x4 &to,
+        float alpha
+    );
+
+    /** Batched CalculateWorldMatrix: writes the matrices of the transforms [first, first + count) to `matrices`.
+     * Eight transforms at a time with AVX2, four with SSE, one at a time otherwise.
+     */
+    void ComposeWorldMatrices(
+        const TransformArrays &transforms,
+        size_t first,
+        size_t count,
+        glm::mat4x4 *matrices
+    );
+
+    /** Batched parent * local multiply: `results[i] = *parents[i] * locals[i]`, in increasing `i`, so a parent
+     * may point to an earlier result of the same batch (e.g. in a hierarchy order, where parents come first).
+     * A null parent copies the local matrix. `locals` and `results` must not overlap.
+     */
+    void MultiplyWorldMatrices(
+        size_t count,
+        const glm::mat4x4 *const *parents,
+        const glm::mat4x4 *locals,
+        glm::mat4x4 *results
+    );
 }
 
 
@@ -0,0 +1,117 @@
+#ifndef VEE_MEMORY_ARENA_H
+#define VEE_MEMORY_ARENA_H
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+
+namespace Utils {
+    /** Snapshot of the counters of a MemoryArena.
+     */
+    struct MemoryArenaStatistics {
+        /** Bytes currently obtained from the system (pool pages and over-aligned blocks).
+         */
+        size_t reservedBytes = 0;
+        /** Bytes currently handed out to containers.
+         */
+        size_t usedBytes = 0;
+        /** Live allocations.
+         */
+        size_t allocationCount = 0;
+        /** Allocations made since the arena was created.
+         */
+        size_t totalAllocations = 0;
+    };
+
+    /** Memory resource grouping the allocations of one owner (typically a Scene).
+     *
+     * Small and medium allocations are carved out of pages by a pool resource, so freeing is a push on a
+     * free list and destroying the arena gives every page back at once. Allocations with an alignment
+     * stricter than `std::max_align_t` (e.g. archetype chunks) bypass the pool, which does not guarantee
+     * it, and go straight to the system allocator. Thread-safe.
+     */
+    class MemoryArena final : public std::pmr::memory_resource {
+        /** Upstream resource counting the bytes obtained from the system.
+         */
+        class SystemResource final : public std::pmr::memory_resource {
+            std::atomic<size_t> m_Bytes = 0;
+
+            void *do_allocate(const size_t bytes, const size_t alignment) override {
+                void *ptr = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+                m_Bytes.fetch_add(bytes, std::memory_order_relaxed);
+                return ptr;
+            }
+
+            void do_deallocate(void *ptr, const size_t bytes, const size_t alignment) override {
+                std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+                m_Bytes.fetch_sub(bytes, std::memory_order_relaxed);
+            }
+
+            [[nodiscard]] bool do_is_equal(const memory_resource &other) const noexcept override {
+                return this == &other;
+            }
+
+        public:
+            [[nodiscard]] size_t GetBytes() const {
+                return m_Bytes.load(std::memory_order_relaxed);
+            }
+        };
+
+        /** Largest allocation served by the pool; larger ones are forwarded to the system one by one.
+         */
+        static constexpr size_t LARGEST_POOL_BLOCK = 64 * 1024;
+
+        SystemResource m_System;
+        std::pmr::synchronized_pool_resource m_Pool;
+
+        std::atomic<size_t> m_UsedBytes = 0;
+        std::atomic<size_t> m_AllocationCount = 0;
+        std::atomic<size_t> m_TotalAllocations = 0;
+
+        [[nodiscard]] static bool IsOverAligned(const size_t alignment) {
+            return alignment > alignof(std::max_align_t);
+        }
+
+        void *do_allocate(const size_t bytes, const size_t alignment) override {
+            void *ptr = IsOverAligned(alignment)
+                            ? m_System.allocate(bytes, alignment)
+                            : m_Pool.allocate(bytes, alignment);
+            m_UsedBytes.fetch_add(bytes, std::memory_order_relaxed);
+            m_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+            m_TotalAllocations.fetch_add(1, std::memory_order_relaxed);
+            return ptr;
+        }
+
+        void do_deallocate(void *ptr, const size_t bytes, const size_t alignment) override {
+            if (IsOverAligned(alignment)) {
+                m_System.deallocate(ptr, bytes, alignment);
+            } else {
+                m_Pool.deallocate(ptr, bytes, alignment);
+            }
+            m_UsedBytes.fetch_sub(bytes, std::memory_order_relaxed);
+            m_AllocationCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] bool do_is_equal(const memory_resource &other) const noexcept override {
+            return this == &other;
+        }
+
+    public:
+        MemoryArena() : m_Pool(std::pmr::pool_options{.largest_required_pool_block = LARGEST_POOL_BLOCK}, &m_System) {
+        }
+
+        MemoryArena(const MemoryArena &) = delete;
+
+        MemoryArena &operator=(const MemoryArena &) = delete;
+
+        [[nodiscard]] MemoryArenaStatistics GetStatistics() const {
+            return {
+                .reservedBytes = m_System.GetBytes(),
+                .usedBytes = m_UsedBytes.load(std::memory_order_relaxed),
+                .allocationCount = m_AllocationCount.load(std::memory_order_relaxed),
+                .totalAllocations = m_TotalAllocations.load(std::memory_order_relaxed),
+            };
+        }
+    };
+}
+
+#endif //VEE_MEMORY_ARENA_H
@@ -0,0 +1,107 @@
+#ifndef VEE_PAGED_VECTOR_H
+#define VEE_PAGED_VECTOR_H
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+/** Growable array made of fixed-size pages.
+ *
+ * Growing only allocates a new page: existing elements are never copied or moved, and their
+ * addresses stay stable. Elements of a page are contiguous, so a linear walk stays cache-friendly.
+ * Pages are allocated from the memory resource given at construction.
+ */
+template<typename T, size_t PageSize = 4096>
+class PagedVector {
+    static_assert((PageSize & (PageSize - 1)) == 0, "PageSize must be a power of two");
+
+    std::pmr::polymorphic_allocator<T> m_Allocator;
+    std::pmr::vector<T *> m_Pages;
+    size_t m_Size = 0;
+
+    void AllocatePage() {
+        T *page = m_Allocator.allocate(PageSize);
+        std::uninitialized_value_construct_n(page, PageSize);
+        m_Pages.push_back(page);
+    }
+
+public:
+    static constexpr size_t PAGE_SIZE = PageSize;
+
+    explicit PagedVector(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : m_Allocator(resource), m_Pages(resource) {
+    }
+
+    PagedVector(const PagedVector &) = delete;
+
+    PagedVector &operator=(const PagedVector &) = delete;
+
+    ~PagedVector() {
+        Clear();
+    }
+
+    T &operator[](const size_t index) {
+        return m_Pages[index / PageSize][index % PageSize];
+    }
+
+    const T &operator[](const size_t index) const {
+        return m_Pages[index / PageSize][index % PageSize];
+    }
+
+    // Append an element, allocating a new page when the last one is full.
+    T &PushBack(T value) {
+        if (m_Size == m_Pages.size() * PageSize) {
+            AllocatePage();
+        }
+        T &slot = (*this)[m_Size++];
+        slot = std::move(value);
+        return slot;
+    }
+
+    [[nodiscard]] size_t Size() const {
+        return m_Size;
+    }
+
+    [[nodiscard]] size_t PageCount() const {
+        return m_Pages.size();
+    }
+
+    // Returns the contiguous storage of a page; only the first `Size() - page * PAGE_SIZE` elements
+    // of the last page are in use.
+    [[nodiscard]] const T *GetPage(const size_t page) const {
+        return m_Pages[page];
+    }
+
+    // Appends every element to `out`, one page at a time.
+    void CopyTo(std::vector<T> &out) const {
+        out.reserve(out.size() + m_Size);
+        for (size_t first = 0; first < m_Size; first += PageSize) {
+            const T *page = m_Pages[first / PageSize];
+            out.insert(out.end(), page, page + std::min(PageSize, m_Size - first));
+        }
+    }
+
+    // Replaces the content with the given elements, copied one page at a time. Pages already
+    // allocated are reused.
+    void Assign(const std::vector<T> &values) {
+        while (m_Pages.size() * PageSize < values.size()) {
+            AllocatePage();
+        }
+        for (size_t first = 0; first < values.size(); first += PageSize) {
+            const size_t count = std::min(PageSize, values.size() - first);
+            std::copy_n(values.begin() + static_cast<std::ptrdiff_t>(first), count, m_Pages[first / PageSize]);
+        }
+        m_Size = values.size();
+    }
+
+    void Clear() {
+        for (T *page: m_Pages) {
+            std::destroy_n(page, PageSize);
+            m_Allocator.deallocate(page, PageSize);
+        }
+        m_Pages.clear();
+        m_Size = 0;
+    }
+};
+
+#endif //VEE_PAGED_VECTOR_H
@@ -0,0 +1,121 @@
+#ifndef VEE_STRING_POOL_H
+#define VEE_STRING_POOL_H
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Utils {
+    /** Interned string storage.
+     *
+     * Every distinct string is copied once into a block arena, null-terminated, and identified by a dense
+     * StringId. Views returned by Get stay valid for the lifetime of the pool: strings are never moved or
+     * freed, so the pool only grows with the number of distinct strings. All the storage comes from the
+     * memory resource given at construction.
+     */
+    class StringPool {
+    public:
+        using StringId = uint32_t;
+
+        /** Id of the empty string, always present.
+         */
+        static constexpr StringId EMPTY_STRING = 0;
+
+    private:
+        static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+        std::pmr::memory_resource *m_Resource;
+        /** Every block of the arena, with its size.
+         */
+        std::pmr::vector<std::pair<char *, size_t> > m_Blocks;
+        char *m_Block = nullptr;
+        size_t m_BlockUsed = BLOCK_SIZE;
+        size_t m_ByteCount = 0;
+
+        std::pmr::vector<std::string_view> m_Strings;
+        std::pmr::unordered_map<std::string_view, StringId> m_Ids;
+
+        char *AllocateBlock(const size_t size) {
+            auto *block = static_cast<char *>(m_Resource->allocate(size, 1));
+            m_Blocks.emplace_back(block, size);
+            return block;
+        }
+
+        /** Copies the string (and a terminating null character) into the arena.
+         */
+        std::string_view Store(const std::string_view string) {
+            const size_t size = string.size() + 1;
+            char *destination;
+            if (size > BLOCK_SIZE) {
+                // Oversized strings get a block of their own, the current block stays open.
+                destination = AllocateBlock(size);
+            } else {
+                if (m_BlockUsed + size > BLOCK_SIZE) {
+                    m_Block = AllocateBlock(BLOCK_SIZE);
+                    m_BlockUsed = 0;
+                }
+                destination = m_Block + m_BlockUsed;
+                m_BlockUsed += size;
+            }
+
+            std::memcpy(destination, string.data(), string.size());
+            destination[string.size()] = '\0';
+            m_ByteCount += size;
+            return {destination, string.size()};
+        }
+
+    public:
+        explicit StringPool(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : m_Resource(resource), m_Blocks(resource), m_Strings(resource), m_Ids(resource) {
+            m_Strings.emplace_back("");
+            m_Ids.emplace(m_Strings.front(), EMPTY_STRING);
+        }
+
+        StringPool(const StringPool &) = delete;
+
+        StringPool &operator=(const StringPool &) = delete;
+
+        ~StringPool() {
+            for (const auto &[block, size]: m_Blocks) {
+                m_Resource->deallocate(block, size, 1);
+            }
+        }
+
+        /** Returns the id of the string, storing it on first use.
+         */
+        StringId Intern(const std::string_view string) {
+            if (const auto it = m_Ids.find(string); it != m_Ids.end()) {
+                return it->second;
+            }
+
+            const auto id = static_cast<StringId>(m_Strings.size());
+            const auto stored = Store(string);
+            m_Strings.push_back(stored);
+            m_Ids.emplace(stored, id);
+            return id;
+        }
+
+        /** Returns the interned string. Its `data()` is null-terminated.
+         */
+        [[nodiscard]] std::string_view Get(const StringId id) const {
+            return m_Strings[id];
+        }
+
+        /** Number of distinct strings, including the empty string.
+         */
+        [[nodiscard]] size_t Size() const {
+            return m_Strings.size();
+        }
+
+        /** Bytes of string data stored in the arena.
+         */
+        [[nodiscard]] size_t GetByteCount() const {
+            return m_ByteCount;
+        }
+    };
+}
+
+#endif //VEE_STRING_POOL_H
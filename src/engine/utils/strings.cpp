@@ -35,10 +35,10 @@ namespace Utils::Strings {
         return result;
     }
 
-    std::string TruncateString(const std::string &name, const int i) {
+    std::string TruncateString(const std::string_view name, const int i) {
         if (static_cast<int>(name.length()) <= i) {
-            return name;
+            return std::string(name);
         }
-        return name.substr(0, i) + "...";
+        return std::string(name.substr(0, i)) + "...";
     }
 }
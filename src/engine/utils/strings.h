@@ -2,6 +2,7 @@
 #define VEE_STRINGS_H
 
 #include <string>
+#include <string_view>
 
 namespace Utils::Strings {
     std::string ReplaceAll(
@@ -18,7 +19,7 @@ namespace Utils::Strings {
         const std::string &input
     );
 
-    std::string TruncateString(const std::string &name, int i);
+    std::string TruncateString(std::string_view name, int i);
 }
 
 #endif //VEE_STRINGS_H
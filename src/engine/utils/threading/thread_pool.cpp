@@ -0,0 +1,117 @@
+#include "thread_pool.h"
+
+namespace {
+    thread_local const Utils::Threading::ThreadPool *t_CurrentPool = nullptr;
+    thread_local size_t t_CurrentQueueIndex = 0;
+}
+
+Utils::Threading::ThreadPool::ThreadPool(const size_t workerCount) {
+    for (size_t i = 0; i < workerCount + 1; ++i) {
+        m_Queues.push_back(std::make_unique<TaskQueue>());
+    }
+
+    m_Workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        m_Workers.emplace_back(&ThreadPool::WorkerLoop, this, i + 1);
+    }
+}
+
+Utils::Threading::ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(m_SleepMutex);
+        m_Stopping = true;
+    }
+    m_SleepCondition.notify_all();
+
+    for (auto &worker: m_Workers) {
+        worker.join();
+    }
+}
+
+size_t Utils::Threading::ThreadPool::GetDefaultWorkerCount() {
+    const size_t hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+size_t Utils::Threading::ThreadPool::GetCallerQueueIndex() const {
+    return t_CurrentPool == this ? t_CurrentQueueIndex : 0;
+}
+
+bool Utils::Threading::ThreadPool::TryPop(const size_t queueIndex, Task &task) {
+    {
+        auto &own = *m_Queues[queueIndex];
+        std::lock_guard lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    for (size_t offset = 1; offset < m_Queues.size(); ++offset) {
+        auto &victim = *m_Queues[(queueIndex + offset) % m_Queues.size()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool Utils::Threading::ThreadPool::TryRunTask(const size_t queueIndex) {
+    if (m_QueuedTasks.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    Task task;
+    if (!TryPop(queueIndex, task)) {
+        return false;
+    }
+
+    m_QueuedTasks.fetch_sub(1, std::memory_order_acq_rel);
+    task();
+    return true;
+}
+
+void Utils::Threading::ThreadPool::WorkerLoop(const size_t queueIndex) {
+    t_CurrentPool = this;
+    t_CurrentQueueIndex = queueIndex;
+
+    while (!m_Stopping.load(std::memory_order_acquire)) {
+        if (TryRunTask(queueIndex)) {
+            continue;
+        }
+
+        std::unique_lock lock(m_SleepMutex);
+        m_SleepCondition.wait(lock, [this] {
+            return m_Stopping.load(std::memory_order_acquire) || m_QueuedTasks.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+void Utils::Threading::ThreadPool::Submit(Task task) {
+    {
+        auto &queue = *m_Queues[GetCallerQueueIndex()];
+        std::lock_guard lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    {
+        // Taking the sleep mutex orders the increment with a worker about to wait, so no wake-up is lost.
+        std::lock_guard lock(m_SleepMutex);
+        m_QueuedTasks.fetch_add(1, std::memory_order_acq_rel);
+    }
+    m_SleepCondition.notify_one();
+}
+
+void Utils::Threading::ThreadPool::RunUntil(const std::function<bool()> &isDone) {
+    const size_t queueIndex = GetCallerQueueIndex();
+    while (!isDone()) {
+        if (!TryRunTask(queueIndex)) {
+            std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef VEE_UTILS_THREADING_THREAD_POOL_H
+#define VEE_UTILS_THREADING_THREAD_POOL_H
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Utils::Threading {
+    /** Fixed-size pool of worker threads with per-worker task queues and work stealing.
+     *
+     * Tasks submitted from a worker go to that worker's own queue, which it pops in LIFO order
+     * (dependent tasks stay hot in cache). Idle workers steal the oldest task of the other queues.
+     * Tasks submitted from any other thread go to a shared queue.
+     *
+     * The pool has no notion of task groups: callers track completion themselves and wait with
+     * RunUntil, which executes pending tasks on the calling thread instead of blocking it.
+     */
+    class ThreadPool {
+    public:
+        using Task = std::function<void()>;
+
+    private:
+        struct TaskQueue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        /** Queue 0 is shared by external threads, queue `i + 1` belongs to worker `i`.
+         */
+        std::vector<std::unique_ptr<TaskQueue> > m_Queues;
+        std::vector<std::thread> m_Workers;
+
+        std::mutex m_SleepMutex;
+        std::condition_variable m_SleepCondition;
+        std::atomic<size_t> m_QueuedTasks = 0;
+        std::atomic<bool> m_Stopping = false;
+
+        /** Index of the queue owned by the calling thread, 0 if it is not a worker of this pool.
+         */
+        [[nodiscard]] size_t GetCallerQueueIndex() const;
+
+        /** Pops a task from the given queue (newest first) or steals one from another queue (oldest first).
+         */
+        bool TryPop(size_t queueIndex, Task &task);
+
+        /** Runs one pending task, if any.
+         *
+         * @return Whether a task was executed.
+         */
+        bool TryRunTask(size_t queueIndex);
+
+        void WorkerLoop(size_t queueIndex);
+
+    public:
+        /** Creates the pool and starts its workers.
+         *
+         * @param workerCount Number of worker threads. With 0 workers, tasks only run inside RunUntil.
+         */
+        explicit ThreadPool(size_t workerCount = GetDefaultWorkerCount());
+
+        ThreadPool(const ThreadPool &) = delete;
+
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        /** Stops and joins the workers. Tasks still queued are discarded.
+         */
+        ~ThreadPool();
+
+        /** One worker per hardware thread, minus the thread driving the pool.
+         */
+        static size_t GetDefaultWorkerCount();
+
+        [[nodiscard]] size_t GetWorkerCount() const {
+            return m_Workers.size();
+        }
+
+        void Submit(Task task);
+
+        /** Executes pending tasks on the calling thread until `isDone` returns true.
+         */
+        void RunUntil(const std::function<bool()> &isDone);
+    };
+}
+
+#endif //VEE_UTILS_THREADING_THREAD_POOL_H
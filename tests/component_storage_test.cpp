@@ -0,0 +1,86 @@
+/** Component storage tests: retrieving components in both storage modes.
+ *
+ * Usage: vee_component_storage_test (exits with a non-zero status on failure)
+ */
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+
+#include "../src/engine/entities/components_system/component_manager.h"
+#include "../src/engine/entities/components_system/components/local_transform_component.h"
+#include "../src/engine/entities/components_system/components/velocity_component.h"
+#include "../src/engine/utils/entities/iteration.h"
+
+namespace {
+    int g_Failures = 0;
+
+    void Check(const bool condition, const char *storageName, const char *message) {
+        if (!condition) {
+            std::fprintf(stderr, "[%s] FAILED: %s\n", storageName, message);
+            ++g_Failures;
+        }
+    }
+
+    template<typename Func>
+    bool Throws(const Func &func) {
+        try {
+            func();
+        } catch (const std::runtime_error &) {
+            return true;
+        }
+        return false;
+    }
+
+    void TestMissingComponent(const char *storageName, const ComponentStorageMode mode) {
+        const auto entityManager = std::make_shared<EntityManager>();
+        const auto systemManager = std::make_shared<SystemManager>();
+        const auto componentManager = std::make_shared<ComponentManager>(systemManager, entityManager, mode);
+        componentManager->RegisterComponent<LocalTransformComponent>(VEE_LOCAL_TRANSFORM_COMPONENT_NAME);
+        componentManager->RegisterComponent<VelocityComponent>(VEE_VELOCITY_COMPONENT_NAME);
+
+        const EntityID withComponent = entityManager->CreateEntity("With");
+        componentManager->AddComponent(withComponent, LocalTransformComponent{});
+        const EntityID withoutComponent = entityManager->CreateEntity("Without");
+        componentManager->AddComponent(withoutComponent, VelocityComponent{});
+        const EntityID empty = entityManager->CreateEntity("Empty");
+
+        const ChangeVersion version = componentManager->AdvanceChangeVersion();
+        componentManager->AdvanceChangeVersion();
+
+        Check(Throws([&] {
+            (void) componentManager->GetComponent<LocalTransformComponent>(withoutComponent);
+        }), storageName, "GetComponent of a missing component throws");
+        Check(Throws([&] {
+            (void) componentManager->GetComponentReadOnly<LocalTransformComponent>(withoutComponent);
+        }), storageName, "GetComponentReadOnly of a missing component throws");
+        Check(Throws([&] {
+            (void) componentManager->GetComponent<LocalTransformComponent>(empty);
+        }), storageName, "GetComponent on an entity without components throws");
+        Check(Throws([&] {
+            (void) componentManager->GetComponentReadOnly<LocalTransformComponent>(NULL_ENTITY);
+        }), storageName, "GetComponentReadOnly on NULL_ENTITY throws");
+
+        Check(!Throws([&] {
+            (void) componentManager->GetComponentReadOnly<LocalTransformComponent>(withComponent);
+        }), storageName, "GetComponentReadOnly of an existing component succeeds");
+
+        // A failed lookup must not record a write.
+        size_t changed = 0;
+        Utils::Entities::Iteration::View<const LocalTransformComponent>(*componentManager)
+                .ChangedSince<LocalTransformComponent>(version)
+                .Each([&](const LocalTransformComponent &) { ++changed; });
+        Check(changed == 0, storageName, "failed lookups do not mark components as changed");
+    }
+}
+
+int main() {
+    TestMissingComponent("PerType", ComponentStorageMode::PerType);
+    TestMissingComponent("Archetype", ComponentStorageMode::Archetype);
+
+    if (g_Failures != 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", g_Failures);
+        return 1;
+    }
+    std::printf("All component storage checks passed\n");
+    return 0;
+}
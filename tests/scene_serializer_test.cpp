@@ -0,0 +1,117 @@
+/** Scene serializer tests: loading scenes that list children before their parent (saved before scenes were
+ * written in hierarchy order), in both storage modes.
+ *
+ * Usage: vee_scene_serializer_test (exits with a non-zero status on failure)
+ */
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "../src/engine/entities/components_system/components/parent_component.h"
+#include "../src/engine/scenes/scene.h"
+#include "../src/engine/serialization/scene_serializer.h"
+
+namespace {
+    int g_Failures = 0;
+
+    void Check(const bool condition, const char *storageName, const char *message) {
+        if (!condition) {
+            std::fprintf(stderr, "[%s] FAILED: %s\n", storageName, message);
+            ++g_Failures;
+        }
+    }
+
+    /** A three-level chain Root > Middle > Leaf, listed leaf first, with ids in the opposite order.
+     */
+    constexpr auto CHILD_FIRST_SCENE = R"(type: scene
+version: 0
+name: Child First
+
+entities:
+  - id: 1
+    name: Leaf
+    components:
+      - type: ParentComponent
+        parent_id: 3
+      - type: LocalTransformComponent
+        position: [ 1, 0, 0 ]
+        rotation: [ 1, 0, 0, 0 ]
+        scale: [ 1, 1, 1 ]
+  - id: 2
+    name: Root
+    components:
+      - type: LocalTransformComponent
+        position: [ 0, 0, 0 ]
+        rotation: [ 1, 0, 0, 0 ]
+        scale: [ 1, 1, 1 ]
+  - id: 3
+    name: Middle
+    components:
+      - type: ParentComponent
+        parent_id: 2
+      - type: LocalTransformComponent
+        position: [ 0, 1, 0 ]
+        rotation: [ 1, 0, 0, 0 ]
+        scale: [ 1, 1, 1 ]
+)";
+
+    EntityID FindEntity(const Scene &scene, const std::string_view name) {
+        const auto entityManager = scene.GetEntityManager();
+        for (const EntityID entity: entityManager->GetActiveEntities()) {
+            if (entityManager->GetEntityName(entity) == name) {
+                return entity;
+            }
+        }
+        return NULL_ENTITY;
+    }
+
+    void TestChildBeforeParent(const char *storageName, const ComponentStorageMode mode) {
+        const auto scenePath = std::filesystem::temp_directory_path() / "vee_child_first.scene";
+        std::ofstream(scenePath) << CHILD_FIRST_SCENE;
+
+        std::unique_ptr<Scene> scene;
+        try {
+            scene = SceneSerializer::LoadScene(scenePath.string(), nullptr, {}, mode);
+        } catch (const std::exception &e) {
+            std::fprintf(stderr, "[%s] FAILED: loading the scene threw: %s\n", storageName, e.what());
+            ++g_Failures;
+        }
+        std::filesystem::remove(scenePath);
+        if (!scene) {
+            return;
+        }
+
+        const EntityID root = FindEntity(*scene, "Root");
+        const EntityID middle = FindEntity(*scene, "Middle");
+        const EntityID leaf = FindEntity(*scene, "Leaf");
+        Check(root != NULL_ENTITY && middle != NULL_ENTITY && leaf != NULL_ENTITY, storageName,
+              "every entity is loaded");
+
+        const auto componentManager = scene->GetComponentManager();
+        const auto &hierarchy = componentManager->GetHierarchy();
+        Check(hierarchy.GetParent(leaf) == middle, storageName, "the leaf is parented to the middle entity");
+        Check(hierarchy.GetParent(middle) == root, storageName, "the middle entity is parented to the root");
+        Check(hierarchy.GetParent(root) == NULL_ENTITY, storageName, "the root has no parent");
+        Check(componentManager->GetComponentReadOnly<ParentComponent>(leaf).parent == middle, storageName,
+              "the ParentComponent mirrors the hierarchy");
+        Check(hierarchy.GetPosition(root) < hierarchy.GetPosition(middle) &&
+              hierarchy.GetPosition(middle) < hierarchy.GetPosition(leaf), storageName,
+              "parents come before their children in the hierarchy order");
+    }
+}
+
+int main() {
+    TestChildBeforeParent("PerType", ComponentStorageMode::PerType);
+    TestChildBeforeParent("Archetype", ComponentStorageMode::Archetype);
+
+    if (g_Failures != 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", g_Failures);
+        return 1;
+    }
+    std::printf("All scene serializer checks passed\n");
+    return 0;
+}
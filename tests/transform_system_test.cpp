@@ -0,0 +1,217 @@
+/** Transform system tests: structural changes (entities created, destroyed or reparented) only recompute the
+ * affected subtrees, and the cached world matrices stay correct, in both storage modes.
+ *
+ * Usage: vee_transform_system_test (exits with a non-zero status on failure)
+ */
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../src/engine/entities/components_system/component_manager.h"
+#include "../src/engine/entities/components_system/components/local_to_world_component.h"
+#include "../src/engine/entities/components_system/components/local_transform_component.h"
+#include "../src/engine/entities/components_system/components/parent_component.h"
+#include "../src/engine/entities/system/transform_system.h"
+#include "../src/engine/utils/entities/iteration.h"
+
+namespace {
+    int g_Failures = 0;
+
+    void Check(const bool condition, const char *storageName, const char *message) {
+        if (!condition) {
+            std::fprintf(stderr, "[%s] FAILED: %s\n", storageName, message);
+            ++g_Failures;
+        }
+    }
+
+    struct World {
+        std::shared_ptr<EntityManager> entityManager = std::make_shared<EntityManager>();
+        std::shared_ptr<SystemManager> systemManager = std::make_shared<SystemManager>();
+        std::shared_ptr<ComponentManager> componentManager;
+        std::shared_ptr<TransformSystem> transformSystem;
+        std::vector<EntityID> entities;
+
+        explicit World(const ComponentStorageMode mode) {
+            componentManager = std::make_shared<ComponentManager>(systemManager, entityManager, mode);
+            componentManager->RegisterComponent<LocalTransformComponent>(VEE_LOCAL_TRANSFORM_COMPONENT_NAME);
+            componentManager->RegisterComponent<LocalToWorldComponent>(VEE_LOCAL_TO_WORLD_COMPONENT_NAME);
+            componentManager->RegisterComponent<ParentComponent>(VEE_PARENT_COMPONENT_NAME);
+
+            Signature signature;
+            signature.set(ComponentTypeHelper<LocalTransformComponent>::ID);
+            signature.set(ComponentTypeHelper<LocalToWorldComponent>::ID);
+            transformSystem = systemManager->RegisterSystem<TransformSystem>(
+                std::make_shared<TransformSystem>(componentManager)
+            );
+            systemManager->SetSignature<TransformSystem>(signature);
+        }
+
+        /** Runs the systems, and returns the change version of the update.
+         */
+        ChangeVersion Update() const {
+            const ChangeVersion version = componentManager->AdvanceChangeVersion();
+            systemManager->UpdateSystems(0.0f, version, nullptr);
+            return version;
+        }
+
+        /** Creates a transformed entity, slightly offset and rotated from its parent.
+         */
+        EntityID Spawn(const EntityID parent) {
+            const EntityID entity = entityManager->CreateEntity("Part");
+            componentManager->AddComponent(entity, LocalTransformComponent{
+                .position = glm::vec3(1.0f, 0.5f * static_cast<float>(entities.size() % 7), 0.0f),
+                .rotation = glm::angleAxis(0.1f * static_cast<float>(entities.size() % 5), glm::vec3(0.0f, 1.0f, 0.0f)),
+                .scale = glm::vec3(1.0f)
+            });
+            componentManager->AddComponent(entity, LocalToWorldComponent{});
+            if (parent != NULL_ENTITY) {
+                componentManager->SetParent(entity, parent);
+            }
+            entities.push_back(entity);
+            return entity;
+        }
+
+        void Destroy(const EntityID entity) const {
+            entityManager->RemoveEntity(entity);
+            componentManager->RemoveEntity(entity);
+            systemManager->RemoveEntity(entity);
+        }
+
+        /** Runs an update without changes, which settles the entities written by the previous one (see
+         *  TransformSystem::SettleRange), so that the next update only writes what it recomputes.
+         */
+        void Settle() const {
+            Update();
+        }
+
+        /** Whether the update at `version` wrote the LocalToWorldComponent of `expected` entities. Only
+         *  checked in PerType mode: Archetype mode tracks changes per chunk, so an entity added to a chunk
+         *  marks the local transforms of its neighbours as changed too, and they are recomputed.
+         */
+        [[nodiscard]] bool Wrote(const ChangeVersion version, const size_t expected) const {
+            if (componentManager->GetStorageMode() == ComponentStorageMode::Archetype) {
+                return true;
+            }
+            size_t written = 0;
+            Utils::Entities::Iteration::View<const LocalToWorldComponent>(*componentManager)
+                    .ChangedSince<LocalToWorldComponent>(version)
+                    .Each([&](const LocalToWorldComponent &) { ++written; });
+            return written == expected;
+        }
+
+        /** World matrix composed from the local transforms up the parent chain.
+         */
+        [[nodiscard]] glm::mat4 ExpectedWorldMatrix(const EntityID entity) const {
+            glm::mat4 matrix(1.0f);
+            if (componentManager->HasComponent<LocalTransformComponent>(entity)) {
+                const auto &transform = componentManager->GetComponentReadOnly<LocalTransformComponent>(entity);
+                matrix = glm::translate(glm::mat4(1.0f), transform.position) * glm::mat4_cast(transform.rotation) *
+                         glm::scale(glm::mat4(1.0f), transform.scale);
+            }
+            const EntityID parent = componentManager->GetHierarchy().GetParent(entity);
+            return parent != NULL_ENTITY ? ExpectedWorldMatrix(parent) * matrix : matrix;
+        }
+
+        /** Whether every live entity has its expected world matrix, and is settled (not interpolated) when
+         *  `settled` is set.
+         */
+        [[nodiscard]] bool MatricesMatch(const bool settled) const {
+            for (const EntityID entity: entities) {
+                if (!entityManager->IsAlive(entity)) {
+                    continue;
+                }
+                const auto &localToWorld = componentManager->GetComponentReadOnly<LocalToWorldComponent>(entity);
+                if (localToWorld.isDirty || !Near(localToWorld.localToWorldMatrix, ExpectedWorldMatrix(entity))) {
+                    return false;
+                }
+                if (settled && localToWorld.previousLocalToWorldMatrix != localToWorld.localToWorldMatrix) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static bool Near(const glm::mat4 &a, const glm::mat4 &b) {
+            for (int column = 0; column < 4; ++column) {
+                for (int row = 0; row < 4; ++row) {
+                    if (std::fabs(a[column][row] - b[column][row]) > 1e-4f * (1.0f + std::fabs(b[column][row]))) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+    };
+
+    constexpr uint32_t ROOT_COUNT = 64;
+    constexpr uint32_t CHILD_COUNT = 3;
+
+    /** Roots with a few children each, updated once.
+     */
+    std::vector<EntityID> SpawnForest(World &world) {
+        std::vector<EntityID> roots;
+        for (uint32_t i = 0; i < ROOT_COUNT; ++i) {
+            const EntityID root = world.Spawn(NULL_ENTITY);
+            for (uint32_t j = 0; j < CHILD_COUNT; ++j) {
+                world.Spawn(root);
+            }
+            roots.push_back(root);
+        }
+        world.Update();
+        world.Settle();
+        return roots;
+    }
+
+    void TestCreatingEntity(const char *storageName, const ComponentStorageMode mode) {
+        World world(mode);
+        const std::vector<EntityID> roots = SpawnForest(world);
+
+        world.Spawn(NULL_ENTITY);
+        Check(world.Wrote(world.Update(), 1), storageName, "creating a root only writes that root");
+        world.Settle();
+
+        // The child is inserted in the middle of the order, moving every later position.
+        world.Spawn(roots[ROOT_COUNT / 2]);
+        Check(world.Wrote(world.Update(), 1), storageName, "creating a child only writes that child");
+        Check(world.MatricesMatch(false), storageName, "world matrices after creating entities");
+    }
+
+    void TestStructuralChanges(const char *storageName, const ComponentStorageMode mode) {
+        World world(mode);
+        const std::vector<EntityID> roots = SpawnForest(world);
+
+        // Reparenting moves the whole subtree, which is recomputed with its new parent.
+        world.componentManager->SetParent(roots[3], roots[40]);
+        Check(world.Wrote(world.Update(), 1 + CHILD_COUNT), storageName, "reparenting only writes the moved subtree");
+        Check(world.MatricesMatch(false), storageName, "world matrices after reparenting");
+        world.Settle();
+
+        // The children of a destroyed entity become roots.
+        world.Destroy(roots[40]);
+        Check(world.Wrote(world.Update(), 1 + 2 * CHILD_COUNT), storageName,
+              "destroying an entity only writes its orphaned subtrees");
+        Check(world.MatricesMatch(false), storageName, "world matrices after destroying an entity");
+
+        // A subtree moved by the previous updates settles like any other.
+        world.componentManager->GetComponent<LocalTransformComponent>(roots[7]).position.z += 1.0f;
+        world.Update();
+        world.Settle();
+        Check(world.MatricesMatch(true), storageName, "world matrices settle after structural changes");
+    }
+}
+
+int main() {
+    TestCreatingEntity("PerType", ComponentStorageMode::PerType);
+    TestCreatingEntity("Archetype", ComponentStorageMode::Archetype);
+    TestStructuralChanges("PerType", ComponentStorageMode::PerType);
+    TestStructuralChanges("Archetype", ComponentStorageMode::Archetype);
+
+    if (g_Failures != 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", g_Failures);
+        return 1;
+    }
+    std::printf("All transform system checks passed\n");
+    return 0;
+}